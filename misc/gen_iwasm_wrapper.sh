@@ -15,8 +15,14 @@ cat <<EOT > $SCRIPT_DIR/iwasm-wrapper
 ### Wrapper for running WASM programs by pointing to built iwasm in root WALI dir 
 
 WL_VERBOSITY=\${WALI_VERBOSE:-0}
+# WALI_STRACE=bin:<path> records a binary trace instead of printing text
+# (iwasm built with -DWALI_ENABLE_SYSCALL_TRACE=1); decode it with
+# utility/decode_trace.py
 if [ -z "\${WALI_STRACE}" ]; then
     STRACE_ARG=""
+elif [[ "\${WALI_STRACE}" == bin:* ]]; then
+    STRACE_ARG=""
+    export WALI_STRACE_FILE="\${WALI_STRACE#bin:}"
 elif [[ "\${WALI_STRACE}" =~ ^-?[0-9]+$ ]]; then
     STRACE_ARG="--strace"
 else
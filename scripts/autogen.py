@@ -163,19 +163,58 @@ def gen_wamr_stubs(spath, syscall_info, archs):
                 fn_name = fn_name,
                 arglist = ''.join([', long a{}'.format(i+1) for i, j in enumerate(args)]))
 
+    def xlate_args(nr, fn_name, args):
+        """
+            Guest iovec and msghdr arrays are widened through iovec.h rather
+            than passed through MADDR; returns (setup lines, call args, result wrapper)
+        """
+        setup, call, wrap = [], [], "{}"
+        for i, argty in enumerate(args):
+            a = f"a{i+1}"
+            if argty == 'struct iovec*':
+                setup += [f"\tstruct iovec iov{i+1}_fast[WALI_IOV_FAST];",
+                          f"\tint iovcnt{i+1} = a{i+2};",
+                          f"\tstruct iovec *iov{i+1} = wali_iov_in(get_module_inst(exec_env), {a}, &iovcnt{i+1}, iov{i+1}_fast);",
+                          f"\tif (!iov{i+1}) {{",
+                          f"\t\tRETURN(TRACE_RET({nr}, PROF_FAIL({nr}, iovcnt{i+1})));",
+                          "\t}"]
+                call.append(f"iov{i+1}")
+            elif i and args[i-1] == 'struct iovec*':
+                call.append(f"iovcnt{i}")
+            elif argty == 'struct msghdr*':
+                setup += [f"\twali_msghdr_host msg{i+1};",
+                          f"\tlong msg{i+1}_err = wali_msghdr_in(get_module_inst(exec_env), {a}, &msg{i+1}, {int(fn_name == 'recvmsg')});",
+                          f"\tif (msg{i+1}_err) {{",
+                          f"\t\tRETURN(TRACE_RET({nr}, PROF_FAIL({nr}, msg{i+1}_err)));",
+                          "\t}"]
+                call.append(f"&msg{i+1}.msg")
+                wrap = f"wali_msghdr_out(get_module_inst(exec_env), &msg{i+1}, {{}})"
+            else:
+                call.append(a if argty[-1] != '*' else f"MADDR({a})")
+        return setup, call, wrap
+
     def impl_stub(nr, nargs, name, fn_name, args):
+        setup, call, wrap = xlate_args(nr, fn_name, args)
         lines = [f"// {nr} TODO",
                 "long wali_syscall_{fn_name} (wasm_exec_env_t exec_env{arglist}) {{".format(
                     fn_name = fn_name, 
                     arglist = ''.join([f", long a{i+1}" for i, j in enumerate(args)])),
 
                 f"\tSC({nr} ,{fn_name});",
-                f"\tERRSC({fn_name});",
-                "\tRETURN(__syscall{num_args}(SYS_{fn_name}{arglist}));".format(
+                f"\tPROF_ENTER({nr});",
+                "\tTRACE_ENTER({nr}, {num_args}{arglist});".format(
+                    nr = nr,
                     num_args = len(args),
-                    fn_name = fn_name,
-                    arglist = ''.join([f", a{i+1}" if argty[-1] != '*' else f", MADDR(a{i+1})"
-                        for i, argty in enumerate(args)])),
+                    arglist = ''.join([f", a{i+1}" if i < len(args) else ", 0" for i in range(6)])),
+                f"\tERRSC({fn_name});",
+                *setup,
+                "\tRETURN(TRACE_RET({nr}, {call}));".format(
+                    nr = nr,
+                    call = wrap.format("PROF_HOST({nr}, __syscall{num_args}(SYS_{fn_name}{arglist}))".format(
+                        nr = nr,
+                        num_args = len(args),
+                        fn_name = fn_name,
+                        arglist = ''.join([f", {x}" for x in call])))),
                 
                 "}\n"
                 ] if nargs else [""]
@@ -199,6 +238,24 @@ def gen_wamr_stubs(spath, syscall_info, archs):
     gen_and_write(impl_stub, syscall_info, spath / 'impl.out')
     gen_and_write(symbols_stub, syscall_info, spath / 'symbols.out')
 
+    # Profiling (PROF_*), binary tracing (TRACE_*) and iovec/msghdr translation
+    # helpers used by the impl stubs
+    impl_info = [sc for sc in syscall_info if sc['# Args']]
+    names = ["\t[{}] = \"{}\",".format(sc['NR'], sc['Aliases'] if sc['Aliases'] else sc['Syscall'])
+                for sc in impl_info]
+    for template_file, out_file in [('wali_prof.h.template', 'prof.h'), ('wali_trace.h.template', 'trace.h'),
+                                    ('wali_iovec.h.template', 'iovec.h')]:
+        with open('templates/' + template_file, 'r') as f:
+            template = f.read()
+
+        fill_temp = template.replace(
+            '[[MAX_NR_STUB]]', str(max(int(sc['NR']) for sc in impl_info))
+            ).replace(
+            '[[SYSCALL_NAMES_STUB]]', '\n'.join(names))
+
+        with open(spath / out_file, 'w') as f:
+            f.write(fill_temp)
+
 
 def gen_wit_stubs(spath, syscall_info, archs):
     """
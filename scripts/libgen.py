@@ -0,0 +1,631 @@
+"""
+    Native library bridge generator
+
+    Counterpart of autogen.py for host libraries (zlib, ...): reads a
+    python-script specification from libspecs/<name>.py and emits
+
+      <name>.h           guest shim header (wasm imports), for wali_shims/
+      lib_<name>.c       WAMR native wrappers + NativeSymbol table
+      lib_<name>.cmake   WAMR build integration
+      symbols.out        one NSYMBOL line per import, like autogen's wamr stubs
+
+    Every wrapper is generated straight-line for its own signature: pointer
+    validation, handle lookup, struct sync and width conversion are emitted
+    inline, nothing is interpreted at run time.
+
+    Spec vocabulary (see libspecs/zlib.py):
+      Val(name, ctype)                scalar by value
+      InBuf/OutBuf(name, ctype, size) guest buffer read/written during the call;
+                                      size is a C expression over the arguments
+      CStr(name)                      NUL-terminated guest string ('$')
+      Scalar(name, ctype, host_ctype, mode)
+                                      pointer to one guest scalar copied into a
+                                      host_ctype local and back (mode 'in'/'out'/'inout')
+      Handle(name, htype)             uint32 guest handle for a host pointer
+      Struct(name, stype)             guest struct mirrored by a persistent
+                                      native struct, synced before/after the call
+      Function(name, ret, args, ...)  one import; ret is a ctype, 'void' or
+                                      HandleRet(htype)
+"""
+import argparse
+import importlib.util
+import logging
+import sys
+from pathlib import Path
+from typing import List
+
+# Guest (wasm32) scalar types -> WAMR signature character
+WASM_SIG = {
+    **{t: 'i' for t in ['int', 'unsigned', 'unsigned int', 'uInt', 'uLong', 'uLongf',
+                        'size_t', 'z_size_t', 'int32_t', 'uint32_t', 'long', 'char']},
+    **{t: 'I' for t in ['int64_t', 'uint64_t', 'long long', 'z_off_t', 'z_off64_t', 'off_t']},
+    'float': 'f',
+    'double': 'F',
+}
+
+# Struct field kinds: guest storage type and how to sync it
+FIELD_GUEST = {'ptr': 'uint32_t', 'u32': 'uint32_t', 'int': 'int32_t',
+               'ulong': 'uint32_t', 'u64': 'uint64_t', 'skip': 'uint32_t'}
+
+
+class Arg:
+    kind = 'val'
+
+    def __init__(self, name, ctype, host=None):
+        self.name, self.ctype, self.host = name, ctype, host
+
+
+class Val(Arg):
+    kind = 'val'
+
+
+class InBuf(Arg):
+    kind = 'in'
+
+    def __init__(self, name, ctype='const void *', size=None, host=None):
+        super().__init__(name, ctype, host)
+        self.size = size
+
+
+class OutBuf(InBuf):
+    kind = 'out'
+
+
+class CStr(Arg):
+    kind = 'cstr'
+
+    def __init__(self, name, ctype='const char *', host=None):
+        super().__init__(name, ctype, host)
+
+
+class Scalar(Arg):
+    kind = 'scalar'
+
+    def __init__(self, name, ctype, host_ctype, mode='inout'):
+        super().__init__(name, ctype)
+        self.host_ctype, self.mode = host_ctype, mode
+
+
+class Handle(Arg):
+    kind = 'handle'
+
+    def __init__(self, name, htype):
+        super().__init__(name, htype)
+        self.htype = htype
+
+
+class Struct(Arg):
+    kind = 'struct'
+
+    def __init__(self, name, stype, ctype=None):
+        super().__init__(name, ctype or f"{stype} *")
+        self.stype = stype
+
+
+class HandleRet:
+    def __init__(self, htype):
+        self.htype = htype
+
+
+class Field:
+    def __init__(self, name, kind, size=None):
+        assert kind in FIELD_GUEST, f"unknown field kind {kind}"
+        self.name, self.kind, self.size = name, kind, size
+
+
+class StructDef:
+    """ Guest struct layout plus the host type it mirrors """
+    def __init__(self, name, host_ctype, fields: List[Field]):
+        self.name, self.host_ctype, self.fields = name, host_ctype, fields
+
+
+class HandleDef:
+    """
+        Host pointer type exposed to guests as a generation-checked uint32.
+        destructor releases a host object that no handle could be allocated for.
+    """
+    def __init__(self, name, host_ctype, capacity=4096, destructor=None):
+        assert capacity & (capacity - 1) == 0, "capacity must be a power of 2"
+        self.name, self.host_ctype, self.capacity = name, host_ctype, capacity
+        self.destructor = destructor
+
+
+class Function:
+    def __init__(self, name, ret, args, host_fn=None, import_name=None, error=None,
+                 frees=None, doc=None, manual=False):
+        self.name, self.ret, self.args = name, ret, args
+        self.host_fn = host_fn or name
+        self.import_name = import_name or f"wali_{name}"
+        self.error = error
+        self.frees = frees      # argument name whose handle/struct is released after the call
+        self.doc = doc
+        self.manual = manual    # wrapper hand-written in lib_<name>_manual.c
+
+
+def load_spec(path: Path):
+    # Specs import the vocabulary from "libgen"; make that this module even when run as a script
+    sys.modules.setdefault('libgen', sys.modules[__name__])
+    spec = importlib.util.spec_from_file_location(path.stem, path)
+    mod = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(mod)
+    return mod
+
+
+"""
+    --------------------------------------------------------------
+    Signatures
+    --------------------------------------------------------------
+"""
+def native_sig(fn: Function) -> str:
+    """
+        WAMR signature string. A buffer immediately followed by its own
+        length argument becomes "*~" so the runtime validates and
+        translates it; every other pointer is validated in the wrapper.
+    """
+    params = []
+    args = fn.args
+    for i, a in enumerate(args):
+        if a.kind == 'val':
+            prev = args[i - 1] if i else None
+            params.append('~' if prev is not None and prev.kind in ('in', 'out')
+                          and prev.size == a.name else WASM_SIG[a.ctype])
+        elif a.kind in ('in', 'out'):
+            nxt = args[i + 1] if i + 1 < len(args) else None
+            params.append('*' if nxt is not None and nxt.kind == 'val' and a.size == nxt.name else 'i')
+        elif a.kind == 'cstr':
+            params.append('$')
+        else:
+            params.append('i')
+    if isinstance(fn.ret, HandleRet):
+        res = 'i'
+    elif fn.ret == 'void':
+        res = ''
+    else:
+        res = WASM_SIG.get(fn.ret, 'i')
+    return f"\"({''.join(params)}){res}\""
+
+
+def runtime_checked(fn: Function, idx: int) -> bool:
+    return native_sig(fn).strip('"')[1:].split(')')[0][idx] in '*~$'
+
+
+SIGNED = {'int', 'long', 'char', 'int32_t', 'int64_t', 'long long', 'z_off_t', 'z_off64_t', 'off_t'}
+
+
+def wrapper_ctype(ctype: str) -> str:
+    """ Host type of a scalar as WAMR passes it: wasm widths, not host ones """
+    sig = WASM_SIG.get(ctype, 'i')
+    if sig == 'f':
+        return 'float'
+    if sig == 'F':
+        return 'double'
+    return f"{'' if ctype in SIGNED else 'u'}int{32 if sig == 'i' else 64}_t"
+
+
+"""
+    --------------------------------------------------------------
+    Guest shim header
+    --------------------------------------------------------------
+"""
+def gen_header(spec, outpath: Path):
+    name = spec.LIBRARY
+    guard = f"WALI_{name.upper()}_H_"
+    lines = [
+        f"/* wali_shims/{name}.h",
+        f" * WASM shim header for {name}",
+        f" * Autogenerated by scripts/libgen.py from libspecs/{name}.py",
+        " */",
+        "",
+        f"#ifndef {guard}",
+        f"#define {guard}",
+        "",
+        "#ifdef __cplusplus",
+        "extern \"C\" {",
+        "#endif",
+        "",
+        "#include <stddef.h>",
+        "#include <stdint.h>",
+        "",
+        spec.HEADER_PRELUDE.strip(),
+        "",
+    ]
+    for h in spec.HANDLES:
+        lines.append(f"/* {h.name} is a handle (uint32_t) in WALI, not a pointer. 0 is never valid. */")
+        lines.append(f"typedef uint32_t {h.name};")
+        lines.append("")
+    for fn in spec.FUNCTIONS:
+        if fn.doc:
+            lines.append(f"/* {fn.doc} */")
+        ret = fn.ret.htype if isinstance(fn.ret, HandleRet) else fn.ret
+        params = ', '.join(f"{a.ctype}{'' if a.ctype.endswith('*') else ' '}{a.name}"
+                           for a in fn.args) or 'void'
+        lines.append(f"__attribute__((import_module(\"env\"), import_name(\"{fn.import_name}\")))")
+        lines.append(f"{ret} {fn.name}({params});")
+        lines.append("")
+    lines += [
+        "#ifdef __cplusplus",
+        "}",
+        "#endif",
+        "",
+        f"#endif /* {guard} */",
+        "",
+    ]
+    outpath.write_text('\n'.join(lines))
+
+
+"""
+    --------------------------------------------------------------
+    Host wrappers
+    --------------------------------------------------------------
+"""
+def gen_handle_table(h: HandleDef) -> List[str]:
+    """
+        Slot index in the low bits, generation above it: a stale handle
+        never resolves to a reused slot. Slot 0 is reserved so 0 is invalid.
+    """
+    n, cap = h.name, h.capacity
+    bits = cap.bit_length() - 1
+    return [
+        f"/* ---- {n} handles ---- */",
+        f"#define {n.upper()}_SLOT_BITS {bits}",
+        f"#define {n.upper()}_SLOTS {cap}",
+        f"static struct {{ {h.host_ctype} ptr; uint32_t gen; }} {n}_table[{n.upper()}_SLOTS];",
+        f"static pthread_mutex_t {n}_lock = PTHREAD_MUTEX_INITIALIZER;",
+        "",
+        f"static uint32_t {n}_handle_new({h.host_ctype} ptr) {{",
+        "    uint32_t handle = 0;",
+        "    if (!ptr) {",
+        "        return 0;",
+        "    }",
+        f"    pthread_mutex_lock(&{n}_lock);",
+        f"    for (uint32_t i = 1; i < {n.upper()}_SLOTS; i++) {{",
+        f"        if (!{n}_table[i].ptr) {{",
+        f"            {n}_table[i].ptr = ptr;",
+        f"            {n}_table[i].gen = ({n}_table[i].gen + 1) & ((1u << (32 - {n.upper()}_SLOT_BITS)) - 1);",
+        f"            handle = ({n}_table[i].gen << {n.upper()}_SLOT_BITS) | i;",
+        "            break;",
+        "        }",
+        "    }",
+        f"    pthread_mutex_unlock(&{n}_lock);",
+        "    return handle;",
+        "}",
+        "",
+        f"static inline {h.host_ctype} {n}_handle_get(uint32_t handle) {{",
+        f"    uint32_t i = handle & ({n.upper()}_SLOTS - 1);",
+        f"    {h.host_ctype} ptr = {n}_table[i].ptr;",
+        f"    return ptr && ({n}_table[i].gen << {n.upper()}_SLOT_BITS | i) == handle ? ptr : NULL;",
+        "}",
+        "",
+        f"static void {n}_handle_free(uint32_t handle) {{",
+        f"    uint32_t i = handle & ({n.upper()}_SLOTS - 1);",
+        f"    pthread_mutex_lock(&{n}_lock);",
+        f"    if (({n}_table[i].gen << {n.upper()}_SLOT_BITS | i) == handle) {{",
+        f"        {n}_table[i].ptr = NULL;",
+        "    }",
+        f"    pthread_mutex_unlock(&{n}_lock);",
+        "}",
+        "",
+    ]
+
+
+def gen_struct_support(s: StructDef) -> List[str]:
+    """
+        Guest layout, a persistent native mirror per (instance, guest address)
+        and field-by-field sync functions. Pointer fields are re-translated on
+        every call because linear memory may move when it grows.
+    """
+    n = s.name
+    out = [f"/* ---- {n} mirror ---- */", "typedef struct {"]
+    out += [f"    {FIELD_GUEST[f.kind]} {f.name};" for f in s.fields]
+    out += [f"}} {n}_wasm;", ""]
+
+    out += [
+        f"typedef struct {n}_mirror {{",
+        "    wasm_module_inst_t inst;",
+        "    uint32_t app;",
+        f"    {s.host_ctype} native;",
+        f"    struct {n}_mirror *next;",
+        f"}} {n}_mirror;",
+        "",
+        f"#define {n.upper()}_BUCKETS 1024",
+        f"static {n}_mirror *{n}_buckets[{n.upper()}_BUCKETS];",
+        f"static pthread_mutex_t {n}_lock = PTHREAD_MUTEX_INITIALIZER;",
+        "",
+        f"static {s.host_ctype} *{n}_native(wasm_module_inst_t inst, uint32_t app) {{",
+        f"    uint32_t b = (app >> 3) & ({n.upper()}_BUCKETS - 1);",
+        f"    {n}_mirror *m;",
+        f"    pthread_mutex_lock(&{n}_lock);",
+        f"    for (m = {n}_buckets[b]; m; m = m->next) {{",
+        "        if (m->inst == inst && m->app == app) {",
+        "            break;",
+        "        }",
+        "    }",
+        "    if (!m && (m = calloc(1, sizeof(*m)))) {",
+        "        m->inst = inst;",
+        "        m->app = app;",
+        f"        m->next = {n}_buckets[b];",
+        f"        {n}_buckets[b] = m;",
+        "    }",
+        f"    pthread_mutex_unlock(&{n}_lock);",
+        "    return m ? &m->native : NULL;",
+        "}",
+        "",
+        f"static void {n}_release(wasm_module_inst_t inst, uint32_t app) {{",
+        f"    uint32_t b = (app >> 3) & ({n.upper()}_BUCKETS - 1);",
+        f"    {n}_mirror **p, *m;",
+        f"    pthread_mutex_lock(&{n}_lock);",
+        f"    for (p = &{n}_buckets[b]; (m = *p); p = &m->next) {{",
+        "        if (m->inst == inst && m->app == app) {",
+        "            *p = m->next;",
+        "            free(m);",
+        "            break;",
+        "        }",
+        "    }",
+        f"    pthread_mutex_unlock(&{n}_lock);",
+        "}",
+        "",
+    ]
+
+    # Validate and translate from one snapshot so the guest cannot change a
+    # field between its check and its use
+    sync_in = [
+        f"static int {n}_sync_in(wasm_module_inst_t inst, const {n}_wasm *g_app, {s.host_ctype} *h) {{",
+        f"    {n}_wasm snap;",
+        f"    const {n}_wasm *g = &snap;",
+        "    memcpy(&snap, g_app, sizeof(snap));",
+    ]
+    sync_out = [f"static void {n}_sync_out(wasm_module_inst_t inst, {n}_wasm *g, const {s.host_ctype} *h) {{"]
+    for f in s.fields:
+        if f.kind == 'ptr':
+            size = f"g->{f.size}" if f.size else "1"
+            sync_in += [
+                f"    if (g->{f.name} && !wasm_runtime_validate_app_addr(inst, g->{f.name}, {size})) {{",
+                "        return 0;",
+                "    }",
+                f"    h->{f.name} = g->{f.name} ? wasm_runtime_addr_app_to_native(inst, g->{f.name}) : NULL;",
+            ]
+            sync_out.append(f"    g->{f.name} = h->{f.name} ? "
+                            f"(uint32_t)wasm_runtime_addr_native_to_app(inst, (void *)h->{f.name}) : 0;")
+        elif f.kind == 'skip':
+            continue
+        else:
+            sync_in.append(f"    h->{f.name} = g->{f.name};")
+            sync_out.append(f"    g->{f.name} = ({FIELD_GUEST[f.kind]})h->{f.name};")
+    sync_in += ["    return 1;", "}", ""]
+    sync_out += ["}", ""]
+    return out + sync_in + sync_out
+
+
+def wrapper_params(fn: Function) -> List[str]:
+    """ Parameters as WAMR passes them: translated pointers for '*' and '$' """
+    params = []
+    for i, a in enumerate(fn.args):
+        if a.kind in ('in', 'out') and runtime_checked(fn, i):
+            params.append(f"{'const ' if a.kind == 'in' else ''}void *{a.name}")
+        elif a.kind == 'cstr':
+            params.append(f"const char *{a.name}")
+        elif a.kind == 'val':
+            params.append(f"{wrapper_ctype(a.ctype)} {a.name}")
+        else:
+            params.append(f"uint32_t {a.name}_app")
+    return params
+
+
+def wrapper_ret(fn: Function) -> str:
+    if fn.ret == 'void':
+        return 'void'
+    return 'uint32_t' if isinstance(fn.ret, HandleRet) else wrapper_ctype(fn.ret)
+
+
+def wrapper_proto(fn: Function) -> str:
+    return (f"{wrapper_ret(fn)} {fn.name}_wrapper(wasm_exec_env_t exec_env"
+            + ''.join(f", {p}" for p in wrapper_params(fn)) + ")")
+
+
+def gen_wrapper(spec, fn: Function) -> List[str]:
+    handles = {h.name: h for h in spec.HANDLES}
+    structs = {s.name: s for s in spec.STRUCTS}
+    ret_handle = isinstance(fn.ret, HandleRet)
+    ret_c = wrapper_ret(fn)
+    err = fn.error if fn.error is not None else ('0' if ret_handle else spec.ERROR_RETURN)
+    fail = "return;" if fn.ret == 'void' else f"return {err};"
+
+    body, post = [], []
+    needs_inst = any(a.kind in ('in', 'out', 'scalar', 'struct') and not runtime_checked(fn, i)
+                     for i, a in enumerate(fn.args))
+    if needs_inst:
+        body.append("    wasm_module_inst_t inst = get_module_inst(exec_env);")
+
+    # Scalars are loaded first so buffer sizes may refer to them (compress2's *destLen)
+    order = sorted(range(len(fn.args)), key=lambda i: fn.args[i].kind != 'scalar')
+    call_args = [None] * len(fn.args)
+    for i in order:
+        a = fn.args[i]
+        if a.host is not None:
+            body.append(f"    (void){a.name}{'' if a.kind in ('val', 'cstr') else '_app'};")
+            call_args[i] = a.host
+        elif a.kind in ('val', 'cstr') or (a.kind in ('in', 'out') and runtime_checked(fn, i)):
+            call_args[i] = a.name
+        elif a.kind in ('in', 'out'):
+            body += [
+                f"    if (!wasm_runtime_validate_app_addr(inst, {a.name}_app, (uint64_t)({a.size}))) {{",
+                f"        {fail}",
+                "    }",
+                f"    {'const ' if a.kind == 'in' else ''}void *{a.name} = "
+                f"wasm_runtime_addr_app_to_native(inst, {a.name}_app);",
+            ]
+            call_args[i] = a.name
+        elif a.kind == 'scalar':
+            gty = a.ctype.rstrip(' *')
+            slot = 'uint64_t' if WASM_SIG.get(gty) == 'I' else 'uint32_t'
+            body += [
+                f"    if (!wasm_runtime_validate_app_addr(inst, {a.name}_app, sizeof({slot}))) {{",
+                f"        {fail}",
+                "    }",
+                f"    {slot} *{a.name}_slot = wasm_runtime_addr_app_to_native(inst, {a.name}_app);",
+                f"    {a.host_ctype} {a.name} = {'*' + a.name + '_slot' if a.mode != 'out' else '0'};",
+            ]
+            call_args[i] = f"&{a.name}"
+            if a.mode != 'in':
+                post.append(f"    *{a.name}_slot = ({slot}){a.name};")
+        elif a.kind == 'handle':
+            h = handles[a.htype]
+            body += [
+                f"    {h.host_ctype} {a.name} = {h.name}_handle_get({a.name}_app);",
+                f"    if (!{a.name}) {{",
+                f"        {fail}",
+                "    }",
+            ]
+            call_args[i] = a.name
+            if fn.frees == a.name:
+                post.append(f"    {h.name}_handle_free({a.name}_app);")
+        elif a.kind == 'struct':
+            s = structs[a.stype]
+            body += [
+                f"    if (!wasm_runtime_validate_app_addr(inst, {a.name}_app, sizeof({s.name}_wasm))) {{",
+                f"        {fail}",
+                "    }",
+                f"    {s.name}_wasm *{a.name}_g = wasm_runtime_addr_app_to_native(inst, {a.name}_app);",
+                f"    {s.host_ctype} *{a.name} = {s.name}_native(inst, {a.name}_app);",
+                f"    if (!{a.name} || !{s.name}_sync_in(inst, {a.name}_g, {a.name})) {{",
+                f"        {fail}",
+                "    }",
+            ]
+            call_args[i] = a.name
+            post.append(f"    {s.name}_sync_out(inst, {a.name}_g, {a.name});")
+            if fn.frees == a.name:
+                post.append(f"    {s.name}_release(inst, {a.name}_app);")
+
+    call = f"{fn.host_fn}({', '.join(call_args)})"
+    if fn.ret == 'void':
+        body.append(f"    {call};")
+    elif ret_handle:
+        h = handles[fn.ret.htype]
+        if h.destructor:
+            body += [
+                f"    {h.host_ctype} obj = {call};",
+                f"    uint32_t ret = {h.name}_handle_new(obj);",
+                "    if (!ret && obj) {",
+                f"        {h.destructor}(obj);",
+                "    }",
+            ]
+        else:
+            body.append(f"    uint32_t ret = {h.name}_handle_new({call});")
+    else:
+        body.append(f"    {ret_c} ret = ({ret_c}){call};")
+
+    lines = [f"static {wrapper_proto(fn)} {{"]
+    if not needs_inst:
+        lines.append("    (void)exec_env;")
+    lines += body + post
+    if fn.ret != 'void':
+        lines.append("    return ret;")
+    lines += ["}", ""]
+    return lines
+
+
+def gen_natives(spec, outpath: Path):
+    name = spec.LIBRARY
+    lines = [
+        "/*",
+        f" * lib_{name}.c - WAMR natives for {name}",
+        f" * Autogenerated by scripts/libgen.py from libspecs/{name}.py, do not edit.",
+        f" * Hand-written wrappers (manual=True) live in lib_{name}_manual.c.",
+        " */",
+        "",
+        "#include <pthread.h>",
+        "#include <stdint.h>",
+        "#include <stdlib.h>",
+        "#include <string.h>",
+        "",
+        "#include \"wasm_export.h\"",
+        *[f"#include <{h}>" for h in spec.HOST_INCLUDES],
+        "",
+        "#define NSYMBOL(symbol, fn, sig) { #symbol, (void *)fn, sig, NULL }",
+        "",
+    ]
+    for h in spec.HANDLES:
+        lines += gen_handle_table(h)
+    for s in spec.STRUCTS:
+        lines += gen_struct_support(s)
+    for fn in spec.FUNCTIONS:
+        if fn.manual:
+            lines.append(f"/* {fn.name}: see lib_{name}_manual.c */")
+            lines.append(f"{wrapper_proto(fn)};")
+            lines.append("")
+        else:
+            lines += gen_wrapper(spec, fn)
+    lines.append(f"static NativeSymbol native_symbols_lib_{name}[] = {{")
+    lines += [f"    NSYMBOL({fn.import_name}, {fn.name}_wrapper, {native_sig(fn)}),"
+              for fn in spec.FUNCTIONS]
+    lines += [
+        "};",
+        "",
+        f"uint32_t get_lib_{name}_export_apis(NativeSymbol **p_native_symbols) {{",
+        f"    *p_native_symbols = native_symbols_lib_{name};",
+        f"    return sizeof(native_symbols_lib_{name}) / sizeof(NativeSymbol);",
+        "}",
+        "",
+    ]
+    outpath.write_text('\n'.join(lines))
+
+
+"""
+    --------------------------------------------------------------
+    Build integration and signature list
+    --------------------------------------------------------------
+"""
+def gen_cmake(spec, outpath: Path):
+    name = spec.LIBRARY
+    up = f"LIB_{name.upper()}"
+    outpath.write_text('\n'.join([
+        f"# Autogenerated by scripts/libgen.py from libspecs/{name}.py",
+        f"set ({up}_DIR ${{CMAKE_CURRENT_LIST_DIR}})",
+        "",
+        f"add_definitions (-DWASM_ENABLE_{up}=1)",
+        "",
+        f"include_directories (${{{up}_DIR}})",
+        "",
+        f"file (GLOB source_all ${{{up}_DIR}}/lib_{name}*.c)",
+        "",
+        f"set ({up}_SOURCE ${{source_all}})",
+        f"set ({up}_LINK_LIBS {' '.join(spec.LINK_LIBS)})",
+        "",
+    ]))
+
+
+def gen_symbols(spec, outpath: Path):
+    outpath.write_text('\n'.join(
+        "\tNSYMBOL ( {: >30}, {: >30}, {: >12} ),".format(
+            fn.import_name, fn.name + "_wrapper", native_sig(fn))
+        for fn in spec.FUNCTIONS) + '\n')
+
+
+def parse_args() -> argparse.Namespace:
+    parser = argparse.ArgumentParser(prog='wali-libgen', description="Generate WALI native library bridges from a spec")
+    parser.add_argument('spec', help='Library spec, e.g. libspecs/zlib.py')
+    parser.add_argument('--out', '-o', help='Output directory (default: libgen/<library>)')
+    parser.add_argument('--verbose', '-v', help='Logging verbosity', choices=range(6), type=int, default=4)
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+    logging.basicConfig(level=logging.getLevelName((6-args.verbose)*10) if args.verbose != 0 else logging.NOTSET,
+        format='%(levelname)s: %(message)s')
+    spec = load_spec(Path(args.spec))
+    opath = Path(args.out) if args.out else Path('libgen') / spec.LIBRARY
+    opath.mkdir(parents=True, exist_ok=True)
+
+    logging.info(f"Generating {spec.LIBRARY}: {len(spec.FUNCTIONS)} functions into {opath}")
+    gen_header(spec, opath / f"{spec.LIBRARY}.h")
+    gen_natives(spec, opath / f"lib_{spec.LIBRARY}.c")
+    gen_cmake(spec, opath / f"lib_{spec.LIBRARY}.cmake")
+    gen_symbols(spec, opath / 'symbols.out')
+    manual = [fn.name for fn in spec.FUNCTIONS if fn.manual]
+    if manual:
+        logging.info(f"Hand-written wrappers expected in lib_{spec.LIBRARY}_manual.c: {', '.join(manual)}")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,140 @@
+"""
+    zlib bridge specification for libgen.py
+
+    Covers the one-shot, streaming, checksum and gzip entry points; the
+    batch/dictionary/async extensions stay hand-written in lib_zlib.c.
+    Guest layouts follow wasm32: uLong and pointers are 4 bytes.
+"""
+from libgen import (Val, InBuf, OutBuf, CStr, Scalar, Handle, Struct, HandleRet,
+                    Field, StructDef, HandleDef, Function)
+
+LIBRARY = 'zlib'
+HOST_INCLUDES = ['zlib.h']
+LINK_LIBS = ['z']
+
+# Returned by a wrapper whose arguments fail validation
+ERROR_RETURN = 'Z_STREAM_ERROR'
+
+HEADER_PRELUDE = """
+#define ZLIB_VERSION "1.3"
+
+#define Z_NO_FLUSH      0
+#define Z_SYNC_FLUSH    2
+#define Z_FULL_FLUSH    3
+#define Z_FINISH        4
+
+#define Z_OK            0
+#define Z_STREAM_END    1
+#define Z_NEED_DICT     2
+#define Z_ERRNO        (-1)
+#define Z_STREAM_ERROR (-2)
+#define Z_DATA_ERROR   (-3)
+#define Z_MEM_ERROR    (-4)
+#define Z_BUF_ERROR    (-5)
+
+#define Z_DEFAULT_COMPRESSION  (-1)
+
+typedef unsigned char Bytef;
+typedef unsigned int uInt;
+typedef unsigned long uLong;
+typedef uLong uLongf;
+
+typedef struct z_stream_s {
+    const Bytef *next_in;
+    uint32_t     avail_in;
+    uLong        total_in;
+    Bytef       *next_out;
+    uint32_t     avail_out;
+    uLong        total_out;
+    const char  *msg;
+    void        *state;
+    void        *zalloc;
+    void        *zfree;
+    void        *opaque;
+    int          data_type;
+    uLong        adler;
+    uLong        reserved;
+} z_stream;
+typedef z_stream *z_streamp;
+
+#define deflateInit(strm, level) \\
+        deflateInit_((strm), (level), ZLIB_VERSION, (int)sizeof(z_stream))
+#define inflateInit(strm) \\
+        inflateInit_((strm), ZLIB_VERSION, (int)sizeof(z_stream))
+"""
+
+HANDLES = [
+    HandleDef('gzFile', 'gzFile', destructor='gzclose'),
+]
+
+# msg, state and the allocator fields point into host memory and are
+# never exposed; next_in/next_out are re-translated on every call.
+STRUCTS = [
+    StructDef('z_stream', 'z_stream', [
+        Field('next_in', 'ptr', size='avail_in'),
+        Field('avail_in', 'u32'),
+        Field('total_in', 'ulong'),
+        Field('next_out', 'ptr', size='avail_out'),
+        Field('avail_out', 'u32'),
+        Field('total_out', 'ulong'),
+        Field('msg', 'skip'),
+        Field('state', 'skip'),
+        Field('zalloc', 'skip'),
+        Field('zfree', 'skip'),
+        Field('opaque', 'skip'),
+        Field('data_type', 'int'),
+        Field('adler', 'ulong'),
+        Field('reserved', 'skip'),
+    ]),
+]
+
+# Guest version/stream_size describe the guest struct; the host library
+# is always initialized for its own.
+VERSION = CStr('version', host='ZLIB_VERSION')
+STREAM_SIZE = Val('stream_size', 'int', host='(int)sizeof(z_stream)')
+
+FUNCTIONS = [
+    # One-shot
+    Function('compressBound', 'uLong', [Val('sourceLen', 'uLong')]),
+    Function('compress2', 'int', [
+        OutBuf('dest', 'Bytef *', size='destLen'),
+        Scalar('destLen', 'uLongf *', 'uLongf'),
+        InBuf('source', 'const Bytef *', size='sourceLen'),
+        Val('sourceLen', 'uLong'),
+        Val('level', 'int'),
+    ]),
+    Function('uncompress', 'int', [
+        OutBuf('dest', 'Bytef *', size='destLen'),
+        Scalar('destLen', 'uLongf *', 'uLongf'),
+        InBuf('source', 'const Bytef *', size='sourceLen'),
+        Val('sourceLen', 'uLong'),
+    ]),
+
+    # Streaming
+    Function('deflateInit_', 'int', [Struct('strm', 'z_stream', 'z_streamp'),
+                                     Val('level', 'int'), VERSION, STREAM_SIZE]),
+    Function('deflate', 'int', [Struct('strm', 'z_stream', 'z_streamp'), Val('flush', 'int')]),
+    Function('deflateEnd', 'int', [Struct('strm', 'z_stream', 'z_streamp')], frees='strm'),
+    Function('inflateInit_', 'int', [Struct('strm', 'z_stream', 'z_streamp'), VERSION, STREAM_SIZE]),
+    Function('inflate', 'int', [Struct('strm', 'z_stream', 'z_streamp'), Val('flush', 'int')]),
+    Function('inflateEnd', 'int', [Struct('strm', 'z_stream', 'z_streamp')], frees='strm'),
+
+    # Checksums
+    Function('crc32', 'uLong', [Val('crc', 'uLong'),
+                                InBuf('buf', 'const Bytef *', size='len'), Val('len', 'uInt')]),
+    Function('adler32', 'uLong', [Val('adler', 'uLong'),
+                                  InBuf('buf', 'const Bytef *', size='len'), Val('len', 'uInt')]),
+
+    # Gzip files
+    Function('gzopen', HandleRet('gzFile'), [CStr('path'), CStr('mode')],
+             doc="Returns 0 on failure"),
+    Function('gzread', 'int', [Handle('file', 'gzFile'),
+                               OutBuf('buf', 'void *', size='len'), Val('len', 'unsigned')], error='-1'),
+    Function('gzwrite', 'int', [Handle('file', 'gzFile'),
+                                InBuf('buf', 'const void *', size='len'), Val('len', 'unsigned')], error='0'),
+    Function('gzeof', 'int', [Handle('file', 'gzFile')], error='0'),
+    Function('gzclose', 'int', [Handle('file', 'gzFile')], frees='file'),
+    # Returns a host string that has to be copied into guest memory
+    Function('gzerror', 'const char *', [Handle('file', 'gzFile'), Scalar('errnum', 'int *', 'int', 'out')],
+             manual=True),
+]
@@ -0,0 +1,64 @@
+"""
+    Summarize WALI syscall profile dumps (WALI_SYSCALL_PROF, see
+    templates/wali_prof.h.template). Several dumps, e.g. one per process,
+    are merged before printing.
+"""
+import argparse
+import json
+from collections import defaultdict
+
+
+def merge(paths):
+    merged = defaultdict(lambda: {"count": 0, "translate_ns": 0, "host_ns": 0, "max_ns": 0,
+                                  "hist": defaultdict(int)})
+    for path in paths:
+        with open(path) as f:
+            dump = json.load(f)
+        for sc in dump["syscalls"]:
+            m = merged[sc["name"]]
+            for k in ("count", "translate_ns", "host_ns"):
+                m[k] += sc[k]
+            m["max_ns"] = max(m["max_ns"], sc["max_ns"])
+            for floor, count in sc["hist"]:
+                m["hist"][floor] += count
+    return merged
+
+
+def percentile(hist, count, pct):
+    seen = 0
+    for floor in sorted(hist):
+        seen += hist[floor]
+        if seen * 100 >= count * pct:
+            return floor
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(prog='wali-prof-report', description="Tabulate WALI syscall profile dumps")
+    parser.add_argument('dumps', nargs='+', help='JSON files written by WALI_SYSCALL_PROF')
+    parser.add_argument('--sort', choices=['total', 'count', 'overhead'], default='total')
+    args = parser.parse_args()
+
+    rows = []
+    for name, m in merge(args.dumps).items():
+        n = m["count"]
+        rows.append({
+            "name": name, "count": n,
+            "total": m["translate_ns"] + m["host_ns"],
+            "translate": m["translate_ns"] / n, "host": m["host_ns"] / n,
+            "overhead": m["translate_ns"] / m["host_ns"] * 100 if m["host_ns"] else 0,
+            "p50": percentile(m["hist"], n, 50), "p99": percentile(m["hist"], n, 99),
+            "max": m["max_ns"],
+        })
+    rows.sort(key=lambda r: r[args.sort], reverse=True)
+
+    print("{:<20} {:>10} {:>12} {:>15} {:>12} {:>12} {:>10} {:>10} {:>10}".format(
+        'Syscall', 'Count', 'Total (ms)', 'Translate (ns)', 'Host (ns)', 'Overhead (%)', 'p50 (ns)', 'p99 (ns)', 'Max (ns)'))
+    for r in rows:
+        print("{:<20} {:>10} {:>12.3f} {:>15.1f} {:>12.1f} {:>12.1f} {:>10} {:>10} {:>10}".format(
+            r["name"], r["count"], r["total"] / 1e6, r["translate"], r["host"], r["overhead"],
+            r["p50"], r["p99"], r["max"]))
+
+
+if __name__ == '__main__':
+    main()
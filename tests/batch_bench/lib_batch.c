@@ -0,0 +1,534 @@
+/*
+ * lib_batch.c - Host side of wali_batch_submit (wali_shims/wali_batch.h)
+ *
+ * Registered as a "wali" native the same way lib_bench.c registers its
+ * "env" natives: build this file into iwasm and call
+ * wali_batch_register_natives() after wasm_runtime_full_init().
+ *
+ * Each guest thread gets its own io_uring on first use. A batch is
+ * copied out of linear memory once, validated as a whole, translated into
+ * SQEs, submitted and waited for with a single io_uring_enter, and the
+ * completions are copied back into the guest array. A short submit is
+ * resumed where the kernel stopped; operations it never takes are failed
+ * and removed from the ring. Where io_uring_setup fails (old kernel,
+ * seccomp) the same batch runs as plain syscalls instead: still one guest
+ * transition, but one kernel entry per operation.
+ *
+ * Buffers are translated to native pointers for the duration of the call
+ * only; nothing stays in flight once wali_batch_submit returns, so linear
+ * memory growth cannot invalidate a queued operation. Vectored operations
+ * are widened into a stack array when small and otherwise into a
+ * per-thread scratch array that is kept for the next batch, merging
+ * iovecs that are adjacent in linear memory.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
+#include "wasm_export.h"
+
+#define NATIVE_FUNC(name, func, sig) { #name, (void *)func, sig, NULL }
+
+/* Must match wali_shims/wali_batch.h */
+#define WALI_OP_NOP      0
+#define WALI_OP_READ     1
+#define WALI_OP_WRITE    2
+#define WALI_OP_READV    3
+#define WALI_OP_WRITEV   4
+#define WALI_OP_RECV     5
+#define WALI_OP_SEND     6
+#define WALI_OP_ACCEPT   7
+#define WALI_OP_CLOSE    8
+#define WALI_OP_FSYNC    9
+
+#define WALI_SQE_LINK    1
+#define WALI_BATCH_MAX   256
+
+/* Kernel UIO_MAXIOV: more iovecs than this fail with EINVAL anyway */
+#define BATCH_MAX_IOV    1024
+/* Batches with at most this many iovecs in total do not touch the scratch */
+#define BATCH_FAST_IOV   64
+
+typedef struct {
+    uint8_t  opcode;
+    uint8_t  flags;
+    uint16_t reserved;
+    int32_t  fd;
+    int64_t  off;
+    uint32_t addr;
+    uint32_t len;
+    uint64_t user_data;
+} wali_sqe_wasm;
+
+typedef struct {
+    uint64_t user_data;
+    int32_t  res;
+    uint32_t flags;
+} wali_cqe_wasm;
+
+typedef struct {
+    uint32_t base;
+    uint32_t len;
+} iovec_wasm;
+
+/* One operation after translation to native pointers */
+typedef struct {
+    uint8_t opcode;
+    uint8_t flags;
+    int fd;
+    int64_t off;
+    void *addr;
+    uint32_t len;
+    struct iovec *iov;
+    socklen_t *addrlen;         /* &addrlen_host, or NULL */
+    socklen_t addrlen_host;     /* accept's *addrlen, copied back after completion */
+    socklen_t *addrlen_guest;
+} batch_op;
+
+typedef struct {
+    int fd;                     /* -1: io_uring unavailable, use the fallback */
+    unsigned *sq_head, *sq_tail, *sq_mask, *sq_array;
+    unsigned *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void *sq_ring, *cq_ring;
+    size_t sq_ring_size, cq_ring_size, sqes_size;
+    struct iovec *iov;          /* scratch for large vectored batches */
+    uint64_t iov_cap;
+} batch_ring;
+
+static pthread_key_t ring_key;
+static pthread_once_t ring_key_once = PTHREAD_ONCE_INIT;
+static __thread batch_ring *thread_ring;
+
+static void ring_destroy(void *arg) {
+    batch_ring *r = arg;
+    if (r->fd >= 0) {
+        munmap(r->sqes, r->sqes_size);
+        if (r->cq_ring != r->sq_ring) {
+            munmap(r->cq_ring, r->cq_ring_size);
+        }
+        munmap(r->sq_ring, r->sq_ring_size);
+        close(r->fd);
+    }
+    free(r->iov);
+    free(r);
+}
+
+static void ring_key_init(void) {
+    pthread_key_create(&ring_key, ring_destroy);
+}
+
+static int ring_setup(batch_ring *r) {
+    struct io_uring_params p;
+
+    memset(&p, 0, sizeof(p));
+    r->fd = (int)syscall(SYS_io_uring_setup, WALI_BATCH_MAX, &p);
+    if (r->fd < 0) {
+        return -1;
+    }
+    r->sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    r->cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        r->sq_ring_size = r->cq_ring_size = r->sq_ring_size > r->cq_ring_size
+                                            ? r->sq_ring_size : r->cq_ring_size;
+    }
+    r->sq_ring = mmap(NULL, r->sq_ring_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_SQ_RING);
+    if (r->sq_ring == MAP_FAILED) {
+        goto fail;
+    }
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        r->cq_ring = r->sq_ring;
+    } else {
+        r->cq_ring = mmap(NULL, r->cq_ring_size, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_CQ_RING);
+        if (r->cq_ring == MAP_FAILED) {
+            munmap(r->sq_ring, r->sq_ring_size);
+            goto fail;
+        }
+    }
+    r->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+    r->sqes = mmap(NULL, r->sqes_size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_SQES);
+    if (r->sqes == MAP_FAILED) {
+        if (r->cq_ring != r->sq_ring) {
+            munmap(r->cq_ring, r->cq_ring_size);
+        }
+        munmap(r->sq_ring, r->sq_ring_size);
+        goto fail;
+    }
+    r->sq_head = (unsigned *)((char *)r->sq_ring + p.sq_off.head);
+    r->sq_tail = (unsigned *)((char *)r->sq_ring + p.sq_off.tail);
+    r->sq_mask = (unsigned *)((char *)r->sq_ring + p.sq_off.ring_mask);
+    r->sq_array = (unsigned *)((char *)r->sq_ring + p.sq_off.array);
+    r->cq_head = (unsigned *)((char *)r->cq_ring + p.cq_off.head);
+    r->cq_tail = (unsigned *)((char *)r->cq_ring + p.cq_off.tail);
+    r->cq_mask = (unsigned *)((char *)r->cq_ring + p.cq_off.ring_mask);
+    r->cqes = (struct io_uring_cqe *)((char *)r->cq_ring + p.cq_off.cqes);
+    return 0;
+
+fail:
+    close(r->fd);
+    r->fd = -1;
+    return -1;
+}
+
+static batch_ring *ring_get(void) {
+    batch_ring *r = thread_ring;
+    if (!r) {
+        pthread_once(&ring_key_once, ring_key_init);
+        if (!(r = calloc(1, sizeof(*r)))) {
+            return NULL;
+        }
+        ring_setup(r);
+        pthread_setspecific(ring_key, r);
+        thread_ring = r;
+    }
+    return r;
+}
+
+static int64_t run_one(const batch_op *op) {
+    long res;
+    switch (op->opcode) {
+    case WALI_OP_NOP:
+        return 0;
+    case WALI_OP_READ:
+        res = op->off < 0 ? read(op->fd, op->addr, op->len) : pread(op->fd, op->addr, op->len, op->off);
+        break;
+    case WALI_OP_WRITE:
+        res = op->off < 0 ? write(op->fd, op->addr, op->len) : pwrite(op->fd, op->addr, op->len, op->off);
+        break;
+    case WALI_OP_READV:
+        res = op->off < 0 ? readv(op->fd, op->iov, op->len) : preadv(op->fd, op->iov, op->len, op->off);
+        break;
+    case WALI_OP_WRITEV:
+        res = op->off < 0 ? writev(op->fd, op->iov, op->len) : pwritev(op->fd, op->iov, op->len, op->off);
+        break;
+    case WALI_OP_RECV:
+        res = recv(op->fd, op->addr, op->len, (int)op->off);
+        break;
+    case WALI_OP_SEND:
+        res = send(op->fd, op->addr, op->len, (int)op->off);
+        break;
+    case WALI_OP_ACCEPT:
+        res = accept(op->fd, op->addr, op->addrlen);
+        break;
+    case WALI_OP_CLOSE:
+        res = close(op->fd);
+        break;
+    case WALI_OP_FSYNC:
+        res = fsync(op->fd);
+        break;
+    default:
+        return -EINVAL;
+    }
+    return res < 0 ? -errno : res;
+}
+
+/* Bytes an operation must transfer to count as a success for a link, as
+ * io_uring judges it; -1 if any non-negative result will do */
+static int64_t link_full_len(const batch_op *op) {
+    int64_t len = 0;
+    switch (op->opcode) {
+    case WALI_OP_READ:
+    case WALI_OP_WRITE:
+        return op->len;
+    case WALI_OP_READV:
+    case WALI_OP_WRITEV:
+        for (uint32_t i = 0; i < op->len; i++) {
+            len += (int64_t)op->iov[i].iov_len;
+        }
+        return len;
+    case WALI_OP_RECV:
+    case WALI_OP_SEND:
+        return ((int)op->off & MSG_WAITALL) ? (int64_t)op->len : -1;
+    default:
+        return -1;
+    }
+}
+
+/* Fallback: same semantics, one kernel entry per operation. Like
+ * io_uring, a short transfer breaks a link just as an error does. */
+static void run_plain(const batch_op *ops, uint32_t count, int32_t *res) {
+    int broken = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        res[i] = broken ? -ECANCELED : (int32_t)run_one(&ops[i]);
+        broken = (ops[i].flags & WALI_SQE_LINK)
+                 && (broken || res[i] < 0 || res[i] < link_full_len(&ops[i]));
+    }
+}
+
+static void prep_sqe(struct io_uring_sqe *sqe, const batch_op *op, uint32_t idx) {
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->fd = op->fd;
+    sqe->user_data = idx;
+    sqe->flags = (op->flags & WALI_SQE_LINK) ? IOSQE_IO_LINK : 0;
+    switch (op->opcode) {
+    case WALI_OP_NOP:
+        sqe->opcode = IORING_OP_NOP;
+        break;
+    case WALI_OP_READ:
+    case WALI_OP_WRITE:
+        sqe->opcode = op->opcode == WALI_OP_READ ? IORING_OP_READ : IORING_OP_WRITE;
+        sqe->addr = (uint64_t)(uintptr_t)op->addr;
+        sqe->len = op->len;
+        sqe->off = (uint64_t)op->off;      /* -1: current file position */
+        break;
+    case WALI_OP_READV:
+    case WALI_OP_WRITEV:
+        sqe->opcode = op->opcode == WALI_OP_READV ? IORING_OP_READV : IORING_OP_WRITEV;
+        sqe->addr = (uint64_t)(uintptr_t)op->iov;
+        sqe->len = op->len;
+        sqe->off = (uint64_t)op->off;
+        break;
+    case WALI_OP_RECV:
+    case WALI_OP_SEND:
+        sqe->opcode = op->opcode == WALI_OP_RECV ? IORING_OP_RECV : IORING_OP_SEND;
+        sqe->addr = (uint64_t)(uintptr_t)op->addr;
+        sqe->len = op->len;
+        sqe->msg_flags = (uint32_t)op->off;
+        break;
+    case WALI_OP_ACCEPT:
+        sqe->opcode = IORING_OP_ACCEPT;
+        sqe->addr = (uint64_t)(uintptr_t)op->addr;
+        sqe->addr2 = (uint64_t)(uintptr_t)op->addrlen;
+        break;
+    case WALI_OP_CLOSE:
+        sqe->opcode = IORING_OP_CLOSE;
+        break;
+    case WALI_OP_FSYNC:
+        sqe->opcode = IORING_OP_FSYNC;
+        break;
+    }
+}
+
+/* Copies every posted completion into res; returns how many there were */
+static uint32_t ring_reap(batch_ring *r, int32_t *res) {
+    unsigned head = *r->cq_head;
+    uint32_t reaped = 0;
+
+    while (head != __atomic_load_n(r->cq_tail, __ATOMIC_ACQUIRE)) {
+        struct io_uring_cqe *cqe = &r->cqes[head & *r->cq_mask];
+        res[cqe->user_data] = cqe->res;
+        head++;
+        reaped++;
+    }
+    __atomic_store_n(r->cq_head, head, __ATOMIC_RELEASE);
+    return reaped;
+}
+
+static void run_uring(batch_ring *r, const batch_op *ops, uint32_t count, int32_t *res) {
+    unsigned tail = *r->sq_tail;
+    uint32_t submitted = 0, reaped = 0;
+    long n;
+
+    for (uint32_t i = 0; i < count; i++) {
+        unsigned idx = (tail + i) & *r->sq_mask;
+        prep_sqe(&r->sqes[idx], &ops[i], i);
+        r->sq_array[idx] = idx;
+    }
+    __atomic_store_n(r->sq_tail, tail + count, __ATOMIC_RELEASE);
+
+    /* The kernel does not wait after a short submit (it could not allocate
+     * or prepare an SQE): the rest is still in the ring, so enter again
+     * and it carries on from there */
+    while (submitted < count) {
+        n = syscall(SYS_io_uring_enter, r->fd, count - submitted, count - submitted,
+                    IORING_ENTER_GETEVENTS, NULL, 0);
+        if (n > 0) {
+            submitted += (uint32_t)n;
+        } else if (n == 0 || errno != EINTR) {
+            /* Nothing taken: withdraw the rest from the ring (there is no
+             * SQPOLL thread, so only io_uring_enter consumes it) and fail
+             * them here */
+            int32_t err = n == 0 ? -EAGAIN : -errno;
+            __atomic_store_n(r->sq_tail, tail + submitted, __ATOMIC_RELEASE);
+            for (uint32_t i = submitted; i < count; i++) {
+                res[i] = err;
+            }
+            break;
+        }
+    }
+
+    /* Every submitted SQE points into linear memory, so all of them are
+     * reaped before returning: a signal or error while waiting only means
+     * waiting again */
+    for (;;) {
+        reaped += ring_reap(r, res);
+        if (reaped >= submitted) {
+            return;
+        }
+        syscall(SYS_io_uring_enter, r->fd, 0, submitted - reaped, IORING_ENTER_GETEVENTS, NULL, 0);
+    }
+}
+
+/* Validates and translates one guest operation; 0 or -errno */
+static int translate_op(wasm_module_inst_t inst, const wali_sqe_wasm *g, batch_op *op,
+                        struct iovec **iov_next) {
+    op->opcode = g->opcode;
+    op->flags = g->flags;
+    op->fd = g->fd;
+    op->off = g->off;
+    op->len = g->len;
+    op->addr = NULL;
+    op->iov = NULL;
+    op->addrlen = NULL;
+    op->addrlen_guest = NULL;
+
+    switch (g->opcode) {
+    case WALI_OP_READ:
+    case WALI_OP_WRITE:
+    case WALI_OP_RECV:
+    case WALI_OP_SEND:
+        if (!wasm_runtime_validate_app_addr(inst, g->addr, g->len)) {
+            return -EFAULT;
+        }
+        op->addr = wasm_runtime_addr_app_to_native(inst, g->addr);
+        break;
+    case WALI_OP_READV:
+    case WALI_OP_WRITEV: {
+        iovec_wasm *giov;
+        if (g->len > BATCH_MAX_IOV
+            || !wasm_runtime_validate_app_addr(inst, g->addr, (uint64_t)g->len * sizeof(iovec_wasm))) {
+            return -EINVAL;
+        }
+        giov = wasm_runtime_addr_app_to_native(inst, g->addr);
+        op->iov = *iov_next;
+        op->len = 0;
+        for (uint32_t i = 0, end = 0; i < g->len; i++) {
+            /* Read once: the guest may rewrite the array concurrently */
+            uint32_t base = giov[i].base, len = giov[i].len;
+            if (!len) {
+                continue;
+            }
+            if (!wasm_runtime_validate_app_addr(inst, base, len)) {
+                return -EFAULT;
+            }
+            /* Adjacent in linear memory is adjacent on the host */
+            if (op->len && base == end) {
+                op->iov[op->len - 1].iov_len += len;
+            } else {
+                op->iov[op->len].iov_base = wasm_runtime_addr_app_to_native(inst, base);
+                op->iov[op->len].iov_len = len;
+                op->len++;
+            }
+            end = base + len;
+        }
+        *iov_next += op->len;
+        break;
+    }
+    case WALI_OP_ACCEPT:
+        /* The kernel gets a host copy of *addrlen, so the guest cannot
+         * grow it past the validated buffer while the accept waits */
+        if (g->off) {
+            if (!wasm_runtime_validate_app_addr(inst, (uint64_t)g->off, sizeof(socklen_t))) {
+                return -EFAULT;
+            }
+            op->addrlen_guest = wasm_runtime_addr_app_to_native(inst, (uint64_t)g->off);
+            memcpy(&op->addrlen_host, op->addrlen_guest, sizeof(socklen_t));
+            if (g->addr && !wasm_runtime_validate_app_addr(inst, g->addr, op->addrlen_host)) {
+                return -EFAULT;
+            }
+            op->addrlen = &op->addrlen_host;
+            op->addr = g->addr ? wasm_runtime_addr_app_to_native(inst, g->addr) : NULL;
+        }
+        break;
+    case WALI_OP_NOP:
+    case WALI_OP_CLOSE:
+    case WALI_OP_FSYNC:
+        break;
+    default:
+        return -EINVAL;
+    }
+    return 0;
+}
+
+static int batch_submit_wrapper(wasm_exec_env_t exec_env, uint32_t sqes_app,
+                                uint32_t count, uint32_t cqes_app) {
+    wasm_module_inst_t inst = get_module_inst(exec_env);
+    wali_sqe_wasm g[WALI_BATCH_MAX];
+    batch_op ops[WALI_BATCH_MAX];
+    int32_t res[WALI_BATCH_MAX];
+    wali_cqe_wasm *c;
+    struct iovec iov_fast[BATCH_FAST_IOV], *iov = iov_fast, *iov_next;
+    uint64_t iov_total = 0;
+    batch_ring *r;
+
+    if (count > WALI_BATCH_MAX
+        || !wasm_runtime_validate_app_addr(inst, sqes_app, (uint64_t)count * sizeof(*g))
+        || !wasm_runtime_validate_app_addr(inst, cqes_app, (uint64_t)count * sizeof(*c))) {
+        return -EINVAL;
+    }
+    if (count == 0) {
+        return 0;
+    }
+    /* One snapshot of the guest array: sizing the iovec scratch and
+     * translating must see the same lengths */
+    memcpy(g, wasm_runtime_addr_app_to_native(inst, sqes_app), count * sizeof(*g));
+    c = wasm_runtime_addr_app_to_native(inst, cqes_app);
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (g[i].opcode == WALI_OP_READV || g[i].opcode == WALI_OP_WRITEV) {
+            if (g[i].len > BATCH_MAX_IOV) {
+                return -EINVAL;
+            }
+            iov_total += g[i].len;
+        }
+    }
+    if (!(r = ring_get())) {
+        return -ENOMEM;
+    }
+    if (iov_total > BATCH_FAST_IOV) {
+        if (iov_total > r->iov_cap) {
+            struct iovec *grown = realloc(r->iov, iov_total * sizeof(*iov));
+            if (!grown) {
+                return -ENOMEM;
+            }
+            r->iov = grown;
+            r->iov_cap = iov_total;
+        }
+        iov = r->iov;
+    }
+    iov_next = iov;
+    for (uint32_t i = 0; i < count; i++) {
+        int err = translate_op(inst, &g[i], &ops[i], &iov_next);
+        if (err) {
+            return err;
+        }
+    }
+
+    if (r->fd >= 0) {
+        run_uring(r, ops, count, res);
+    } else {
+        run_plain(ops, count, res);
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (ops[i].addrlen_guest && res[i] >= 0) {
+            memcpy(ops[i].addrlen_guest, &ops[i].addrlen_host, sizeof(socklen_t));
+        }
+        c[i].user_data = g[i].user_data;
+        c[i].res = res[i];
+        c[i].flags = 0;
+    }
+    return (int)count;
+}
+
+static NativeSymbol native_symbols_batch[] = {
+    NATIVE_FUNC(wali_batch_submit, batch_submit_wrapper, "(iii)i"),
+};
+
+int wali_batch_register_natives(void) {
+    return wasm_runtime_register_natives("wali", native_symbols_batch,
+                                         sizeof(native_symbols_batch) / sizeof(NativeSymbol));
+}
@@ -0,0 +1,113 @@
+/*
+ * native_batch.h - wali_batch.h for the batch benchmarks
+ *
+ * WASM builds get the real import. Native builds get a stand-in that runs
+ * each operation as a plain syscall, so the native column is the cost of
+ * the same workload without any guest transition to save.
+ */
+
+#ifndef NATIVE_BATCH_H_
+#define NATIVE_BATCH_H_
+
+#ifdef __wasm__
+#include "wali_batch.h"
+#else
+#include <errno.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#define WALI_OP_NOP      0
+#define WALI_OP_READ     1
+#define WALI_OP_WRITE    2
+#define WALI_OP_RECV     5
+#define WALI_OP_SEND     6
+#define WALI_OP_ACCEPT   7
+#define WALI_OP_CLOSE    8
+
+#define WALI_SQE_LINK    1
+#define WALI_BATCH_MAX   256
+
+typedef struct wali_sqe {
+    uint8_t  opcode;
+    uint8_t  flags;
+    uint16_t reserved;
+    int32_t  fd;
+    int64_t  off;
+    void    *addr;
+    uint32_t len;
+    uint64_t user_data;
+} wali_sqe;
+
+typedef struct wali_cqe {
+    uint64_t user_data;
+    int32_t  res;
+    uint32_t flags;
+} wali_cqe;
+
+static inline void wali_sqe_prep(wali_sqe *sqe, uint8_t opcode, int fd, void *addr,
+                                 uint32_t len, int64_t off, uint64_t user_data) {
+    sqe->opcode = opcode;
+    sqe->flags = 0;
+    sqe->reserved = 0;
+    sqe->fd = fd;
+    sqe->off = off;
+    sqe->addr = addr;
+    sqe->len = len;
+    sqe->user_data = user_data;
+}
+
+static int wali_batch_submit(const wali_sqe *sqes, uint32_t count, wali_cqe *cqes) {
+    int broken = 0;
+    if (count > WALI_BATCH_MAX) {
+        return -EINVAL;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        const wali_sqe *s = &sqes[i];
+        long res = 0;
+        if (broken) {
+            res = -ECANCELED;
+        } else {
+            switch (s->opcode) {
+            case WALI_OP_NOP:
+                break;
+            case WALI_OP_READ:
+                res = s->off < 0 ? read(s->fd, s->addr, s->len) : pread(s->fd, s->addr, s->len, s->off);
+                break;
+            case WALI_OP_WRITE:
+                res = s->off < 0 ? write(s->fd, s->addr, s->len) : pwrite(s->fd, s->addr, s->len, s->off);
+                break;
+            case WALI_OP_RECV:
+                res = recv(s->fd, s->addr, s->len, (int)s->off);
+                break;
+            case WALI_OP_SEND:
+                res = send(s->fd, s->addr, s->len, (int)s->off);
+                break;
+            case WALI_OP_ACCEPT:
+                res = accept(s->fd, NULL, NULL);
+                break;
+            case WALI_OP_CLOSE:
+                res = close(s->fd);
+                break;
+            default:
+                return -EINVAL;
+            }
+            if (res < 0) {
+                res = -errno;
+            }
+        }
+        cqes[i].user_data = s->user_data;
+        cqes[i].res = (int32_t)res;
+        cqes[i].flags = 0;
+        /* A short transfer breaks a link too, see wali_batch.h */
+        broken = (s->flags & WALI_SQE_LINK)
+                 && (res < 0
+                     || ((s->opcode == WALI_OP_READ || s->opcode == WALI_OP_WRITE) && res < s->len)
+                     || ((s->opcode == WALI_OP_RECV || s->opcode == WALI_OP_SEND)
+                         && ((int)s->off & MSG_WAITALL) && res < s->len));
+    }
+    return (int)count;
+}
+#endif
+
+#endif /* NATIVE_BATCH_H_ */
@@ -0,0 +1,242 @@
+/**
+ * Batched Syscall File-Copy Benchmark
+ *
+ * Copies a file chunk by chunk, once with a read()/write() pair per chunk
+ * and once through wali_batch_submit, which reads a whole group of chunks
+ * with one call and writes them back with a second one. Under WALI the
+ * first costs two guest -> host transitions per chunk, the second two per
+ * group.
+ *
+ * Tests:
+ * 1. read/write   - one syscall per operation
+ * 2. batched      - WALI_OP_READ x depth, then WALI_OP_WRITE x depth
+ *
+ * Usage: perf_batch_copy [size_mb] [chunk_kb] [depth]
+ *        (default: 64 MB file, 16 KB chunks, 32 chunks per batch)
+ *
+ * Compile native:
+ *   gcc -O2 -o perf_batch_copy_native perf_batch_copy.c
+ *
+ * Compile WASM:
+ *   ./run_batch_bench.sh builds it (iwasm needs lib_batch.c registered)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "native_batch.h"
+
+#define SRC_FILE "/tmp/wali_batch_src.bin"
+#define DST_FILE "/tmp/wali_batch_dst.bin"
+
+static double get_time_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static int write_source(size_t size, size_t chunk) {
+    unsigned char *buf = malloc(chunk);
+    uint32_t state = 12345;
+    int fd, ret = -1;
+
+    if (!buf || (fd = open(SRC_FILE, O_CREAT | O_TRUNC | O_WRONLY, 0644)) < 0) {
+        free(buf);
+        return -1;
+    }
+    for (size_t done = 0; done < size; done += chunk) {
+        size_t n = size - done < chunk ? size - done : chunk;
+        for (size_t i = 0; i < n; i++) {
+            state = state * 1103515245u + 12345u;
+            buf[i] = (unsigned char)(state >> 16);
+        }
+        if (write(fd, buf, n) != (ssize_t)n) {
+            goto cleanup;
+        }
+    }
+    ret = 0;
+
+cleanup:
+    close(fd);
+    free(buf);
+    return ret;
+}
+
+static int same_files(size_t chunk) {
+    unsigned char *a = malloc(chunk), *b = malloc(chunk);
+    int fa = open(SRC_FILE, O_RDONLY), fb = open(DST_FILE, O_RDONLY);
+    int same = a && b && fa >= 0 && fb >= 0;
+    ssize_t na, nb;
+
+    while (same && (na = read(fa, a, chunk)) > 0) {
+        nb = read(fb, b, chunk);
+        same = nb == na && memcmp(a, b, na) == 0;
+    }
+    if (same && read(fb, b, 1) != 0) {
+        same = 0;
+    }
+    if (fa >= 0) {
+        close(fa);
+    }
+    if (fb >= 0) {
+        close(fb);
+    }
+    free(a);
+    free(b);
+    return same;
+}
+
+static void report(const char *name, size_t size, size_t chunk, double ms, long calls) {
+    printf("  [%-10s] %8.2f ms  %8.1f MB/s  %6.2f us/chunk  %8ld host calls\n",
+           name, ms, (size / 1048576.0) / (ms / 1000.0),
+           ms * 1000.0 / ((size + chunk - 1) / chunk), calls);
+}
+
+/* Test 1: one read() and one write() per chunk */
+static int copy_plain(size_t size, size_t chunk) {
+    unsigned char *buf = malloc(chunk);
+    int in = open(SRC_FILE, O_RDONLY);
+    int out = open(DST_FILE, O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    long calls = 0;
+    double start;
+    ssize_t n;
+    int ret = -1;
+
+    if (!buf || in < 0 || out < 0) {
+        printf("  setup failed\n");
+        goto cleanup;
+    }
+    start = get_time_ms();
+    while ((n = read(in, buf, chunk)) > 0) {
+        calls += 2;
+        if (write(out, buf, n) != n) {
+            printf("  write failed\n");
+            goto cleanup;
+        }
+    }
+    report("read/write", size, chunk, get_time_ms() - start, calls + 1);
+    ret = 0;
+
+cleanup:
+    if (in >= 0) {
+        close(in);
+    }
+    if (out >= 0) {
+        close(out);
+    }
+    free(buf);
+    return ret;
+}
+
+/* Test 2: a batch of reads at explicit offsets, then a batch of writes */
+static int copy_batched(size_t size, size_t chunk, int depth) {
+    unsigned char *bufs = malloc(chunk * depth);
+    wali_sqe *sqes = calloc(depth, sizeof(*sqes));
+    wali_cqe *cqes = calloc(depth, sizeof(*cqes));
+    int in = open(SRC_FILE, O_RDONLY);
+    int out = open(DST_FILE, O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    long calls = 0;
+    double start;
+    int ret = -1;
+
+    if (!bufs || !sqes || !cqes || in < 0 || out < 0) {
+        printf("  setup failed\n");
+        goto cleanup;
+    }
+    start = get_time_ms();
+    for (size_t off = 0; off < size; off += chunk * depth) {
+        int n = 0;
+        for (; n < depth && off + n * chunk < size; n++) {
+            wali_sqe_prep(&sqes[n], WALI_OP_READ, in, bufs + n * chunk, chunk, off + n * chunk, n);
+        }
+        calls++;
+        if (wali_batch_submit(sqes, n, cqes) != n) {
+            printf("  read batch rejected\n");
+            goto cleanup;
+        }
+        for (int i = 0; i < n; i++) {
+            if (cqes[i].res < 0) {
+                printf("  read failed: %d\n", cqes[i].res);
+                goto cleanup;
+            }
+            wali_sqe_prep(&sqes[i], WALI_OP_WRITE, out, bufs + i * chunk, cqes[i].res, off + i * chunk, i);
+        }
+        calls++;
+        if (wali_batch_submit(sqes, n, cqes) != n) {
+            printf("  write batch rejected\n");
+            goto cleanup;
+        }
+        for (int i = 0; i < n; i++) {
+            if (cqes[i].res != (int32_t)sqes[i].len) {
+                printf("  write failed: %d\n", cqes[i].res);
+                goto cleanup;
+            }
+        }
+    }
+    report("batched", size, chunk, get_time_ms() - start, calls);
+    ret = 0;
+
+cleanup:
+    if (in >= 0) {
+        close(in);
+    }
+    if (out >= 0) {
+        close(out);
+    }
+    free(bufs);
+    free(sqes);
+    free(cqes);
+    return ret;
+}
+
+int main(int argc, char *argv[]) {
+    long size_mb = argc > 1 ? atol(argv[1]) : 64;
+    long chunk_kb = argc > 2 ? atol(argv[2]) : 16;
+    int depth = argc > 3 ? atoi(argv[3]) : 32;
+    size_t size = (size_t)size_mb * 1048576, chunk = (size_t)chunk_kb * 1024;
+
+    if (size_mb <= 0 || chunk_kb <= 0 || depth <= 0 || depth > WALI_BATCH_MAX) {
+        printf("Usage: %s [size_mb] [chunk_kb] [depth <= %d]\n", argv[0], WALI_BATCH_MAX);
+        return 1;
+    }
+
+    printf("==================================================\n");
+    printf("  Batched Syscall File-Copy Benchmark\n");
+#ifdef __wasm__
+    printf("  Platform: WebAssembly (WALI)\n");
+#else
+    printf("  Platform: Native (plain syscalls)\n");
+#endif
+    printf("  %ld MB, %ld KB chunks, %d chunks per batch\n", size_mb, chunk_kb, depth);
+    printf("==================================================\n\n");
+
+    if (write_source(size, chunk) != 0) {
+        printf("Could not write %s\n", SRC_FILE);
+        return 1;
+    }
+
+    printf("Test 1: read/write per chunk\n");
+    if (copy_plain(size, chunk) == 0 && !same_files(chunk)) {
+        printf("  copy mismatch\n");
+    }
+    printf("\n");
+
+    printf("Test 2: wali_batch_submit\n");
+    if (copy_batched(size, chunk, depth) == 0 && !same_files(chunk)) {
+        printf("  copy mismatch\n");
+    }
+    printf("\n");
+
+    unlink(SRC_FILE);
+    unlink(DST_FILE);
+
+    printf("==================================================\n");
+    printf("  Batch copy benchmark complete!\n");
+    printf("==================================================\n");
+    return 0;
+}
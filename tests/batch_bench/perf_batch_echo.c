@@ -0,0 +1,269 @@
+/**
+ * Batched Syscall Echo-Server Benchmark
+ *
+ * The tests/socket_server.c server grown into an echo server with many
+ * connections. A forked client opens them all and, each round, sends one
+ * message on every connection before reading every echo back. The server
+ * answers a round either with a recv()/send() pair per connection or with
+ * one wali_batch_submit of all receives and one of all sends. Only the
+ * server loop is timed; the client is the same in both modes.
+ *
+ * Tests:
+ * 1. recv/send   - two syscalls per message
+ * 2. batched     - WALI_OP_RECV x conns, then WALI_OP_SEND x conns
+ *
+ * Usage: perf_batch_echo [conns] [rounds] [msg_size]
+ *        (default: 32 connections, 2000 rounds, 64-byte messages)
+ *
+ * Compile native:
+ *   gcc -O2 -o perf_batch_echo_native perf_batch_echo.c
+ *
+ * Compile WASM:
+ *   ./run_batch_bench.sh builds it (iwasm needs lib_batch.c registered)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#include "native_batch.h"
+
+#define PORT 8080
+#define MAX_CONNS WALI_BATCH_MAX
+#define MAX_MSG 4096
+
+static double get_time_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static int full_io(int fd, char *buf, int len, int sending) {
+    int done = 0;
+    while (done < len) {
+        ssize_t n = sending ? send(fd, buf + done, len - done, 0) : recv(fd, buf + done, len - done, 0);
+        if (n <= 0) {
+            return -1;
+        }
+        done += n;
+    }
+    return 0;
+}
+
+static void nodelay(int fd) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+static int listen_on(int port) {
+    struct sockaddr_in address;
+    int fd, opt = 1;
+
+    if ((fd = socket(AF_INET, SOCK_STREAM, 0)) < 0) {
+        perror("socket failed");
+        return -1;
+    }
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) < 0 || listen(fd, MAX_CONNS) < 0) {
+        perror("bind/listen");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* Forked client: plain syscalls, identical for both server modes */
+static void run_client(int port, int conns, int rounds, int msg_size) {
+    struct sockaddr_in address;
+    int fds[MAX_CONNS];
+    char buf[MAX_MSG];
+
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    memset(buf, 'x', sizeof(buf));
+
+    for (int c = 0; c < conns; c++) {
+        if ((fds[c] = socket(AF_INET, SOCK_STREAM, 0)) < 0 ||
+            connect(fds[c], (struct sockaddr *)&address, sizeof(address)) < 0) {
+            perror("client connect");
+            exit(1);
+        }
+        nodelay(fds[c]);
+    }
+    for (int r = 0; r < rounds; r++) {
+        for (int c = 0; c < conns; c++) {
+            if (full_io(fds[c], buf, msg_size, 1) != 0) {
+                exit(1);
+            }
+        }
+        for (int c = 0; c < conns; c++) {
+            if (full_io(fds[c], buf, msg_size, 0) != 0) {
+                exit(1);
+            }
+        }
+    }
+    for (int c = 0; c < conns; c++) {
+        close(fds[c]);
+    }
+    exit(0);
+}
+
+/* One round, per-connection syscalls */
+static int round_plain(int *conns_fd, int conns, char *bufs, int msg_size) {
+    for (int c = 0; c < conns; c++) {
+        if (full_io(conns_fd[c], bufs + c * MAX_MSG, msg_size, 0) != 0) {
+            return -1;
+        }
+        if (full_io(conns_fd[c], bufs + c * MAX_MSG, msg_size, 1) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* One round, one batch of receives and one of sends */
+static int round_batched(int *conns_fd, int conns, char *bufs, int msg_size,
+                         wali_sqe *sqes, wali_cqe *cqes) {
+    for (int c = 0; c < conns; c++) {
+        wali_sqe_prep(&sqes[c], WALI_OP_RECV, conns_fd[c], bufs + c * MAX_MSG, msg_size, 0, c);
+    }
+    if (wali_batch_submit(sqes, conns, cqes) != conns) {
+        return -1;
+    }
+    for (int c = 0; c < conns; c++) {
+        /* Short reads are rare for small messages; finish them inline */
+        if (cqes[c].res <= 0 || (cqes[c].res < msg_size &&
+            full_io(conns_fd[c], bufs + c * MAX_MSG + cqes[c].res, msg_size - cqes[c].res, 0) != 0)) {
+            return -1;
+        }
+        wali_sqe_prep(&sqes[c], WALI_OP_SEND, conns_fd[c], bufs + c * MAX_MSG, msg_size, 0, c);
+    }
+    if (wali_batch_submit(sqes, conns, cqes) != conns) {
+        return -1;
+    }
+    for (int c = 0; c < conns; c++) {
+        if (cqes[c].res < msg_size &&
+            (cqes[c].res < 0 || full_io(conns_fd[c], bufs + c * MAX_MSG + cqes[c].res,
+                                        msg_size - cqes[c].res, 1) != 0)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static void run_server(int port, int conns, int rounds, int msg_size, int batched) {
+    int server_fd, conns_fd[MAX_CONNS], accepted = 0, status;
+    char *bufs = malloc((size_t)conns * MAX_MSG);
+    wali_sqe sqes[MAX_CONNS];
+    wali_cqe cqes[MAX_CONNS];
+    double start, elapsed;
+    long host_calls = 0;
+    pid_t client;
+
+    if (!bufs || (server_fd = listen_on(port)) < 0) {
+        free(bufs);
+        return;
+    }
+    fflush(stdout);
+    if ((client = fork()) == 0) {
+        close(server_fd);
+        run_client(port, conns, rounds, msg_size);
+    }
+
+    if (batched) {
+        for (int c = 0; c < conns; c++) {
+            wali_sqe_prep(&sqes[c], WALI_OP_ACCEPT, server_fd, NULL, 0, 0, c);
+        }
+        if (wali_batch_submit(sqes, conns, cqes) == conns) {
+            for (; accepted < conns && cqes[accepted].res >= 0; accepted++) {
+                conns_fd[accepted] = cqes[accepted].res;
+            }
+        }
+    } else {
+        for (; accepted < conns; accepted++) {
+            if ((conns_fd[accepted] = accept(server_fd, NULL, NULL)) < 0) {
+                break;
+            }
+        }
+    }
+    if (accepted < conns) {
+        printf("  accepted only %d of %d connections\n", accepted, conns);
+        goto cleanup;
+    }
+    for (int c = 0; c < conns; c++) {
+        nodelay(conns_fd[c]);
+    }
+
+    start = get_time_ms();
+    for (int r = 0; r < rounds; r++) {
+        int ret = batched ? round_batched(conns_fd, conns, bufs, msg_size, sqes, cqes)
+                          : round_plain(conns_fd, conns, bufs, msg_size);
+        if (ret != 0) {
+            printf("  round %d failed\n", r);
+            goto cleanup;
+        }
+        host_calls += batched ? 2 : 2L * conns;
+    }
+    elapsed = get_time_ms() - start;
+
+    printf("  [%-9s] %8.2f ms  %10.0f msg/s  %6.2f us/msg  %8ld host calls\n",
+           batched ? "batched" : "recv/send", elapsed,
+           (double)conns * rounds / (elapsed / 1000.0),
+           elapsed * 1000.0 / ((double)conns * rounds), host_calls);
+
+cleanup:
+    for (int c = 0; c < accepted; c++) {
+        close(conns_fd[c]);
+    }
+    close(server_fd);
+    waitpid(client, &status, 0);
+    free(bufs);
+}
+
+int main(int argc, char *argv[]) {
+    int conns = argc > 1 ? atoi(argv[1]) : 32;
+    int rounds = argc > 2 ? atoi(argv[2]) : 2000;
+    int msg_size = argc > 3 ? atoi(argv[3]) : 64;
+
+    if (conns <= 0 || conns > MAX_CONNS || rounds <= 0 || msg_size <= 0 || msg_size > MAX_MSG) {
+        printf("Usage: %s [conns <= %d] [rounds] [msg_size <= %d]\n", argv[0], MAX_CONNS, MAX_MSG);
+        return 1;
+    }
+
+    printf("==================================================\n");
+    printf("  Batched Syscall Echo-Server Benchmark\n");
+#ifdef __wasm__
+    printf("  Platform: WebAssembly (WALI)\n");
+#else
+    printf("  Platform: Native (plain syscalls)\n");
+#endif
+    printf("  %d connections, %d rounds, %d-byte messages\n", conns, rounds, msg_size);
+    printf("==================================================\n\n");
+
+    printf("Test 1: recv/send per connection\n");
+    run_server(PORT, conns, rounds, msg_size, 0);
+    printf("\n");
+
+    printf("Test 2: wali_batch_submit\n");
+    run_server(PORT, conns, rounds, msg_size, 1);
+    printf("\n");
+
+    printf("==================================================\n");
+    printf("  Batch echo benchmark complete!\n");
+    printf("==================================================\n");
+    return 0;
+}
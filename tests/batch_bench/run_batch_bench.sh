@@ -0,0 +1,99 @@
+#!/bin/bash
+# run_batch_bench.sh - Per-operation syscalls vs wali_batch_submit
+#
+# This script:
+# 1. Compiles perf_batch_copy.c and perf_batch_echo.c natively and for WASM
+# 2. Runs both natively and under iwasm in each runtime mode
+#
+# iwasm must be built with lib_batch.c registered (see the top of that
+# file); without it the WASM runs fail to link wali.wali_batch_submit.
+#
+# Settings:
+#   MODES       runtime modes, default "native interp fast-jit"
+#   COPY_ARGS   perf_batch_copy arguments (default: "64 16 32")
+#   ECHO_ARGS   perf_batch_echo arguments (default: "32 2000 64")
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+WALI_ROOT="${SCRIPT_DIR}/../.."
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+BLUE='\033[0;34m'
+NC='\033[0m' # No Color
+
+IWASM="${WALI_ROOT}/build/wamr/iwasm/iwasm"
+WALI_ENV="${WALI_ROOT}/.walienv"
+
+# WALI toolchain
+WALI_CC="${WALI_ROOT}/build/llvm/bin/clang"
+WALI_SYSROOT="${WALI_ROOT}/build/sysroot"
+
+MODES="${MODES:-native interp fast-jit}"
+COPY_ARGS="${COPY_ARGS:-64 16 32}"
+ECHO_ARGS="${ECHO_ARGS:-32 2000 64}"
+BENCHES="perf_batch_copy perf_batch_echo"
+
+echo -e "${BLUE}╔══════════════════════════════════════════════════════════════╗${NC}"
+echo -e "${BLUE}║         Batched Syscall Submission Benchmarks                ║${NC}"
+echo -e "${BLUE}╚══════════════════════════════════════════════════════════════╝${NC}"
+echo ""
+
+echo -e "${YELLOW}[1/2] Compiling...${NC}"
+SKIP_WASM=0
+if [ ! -f "${WALI_CC}" ] || [ ! -f "${IWASM}" ]; then
+    echo -e "${RED}  ✗ WALI compiler or iwasm not found, skipping WASM modes${NC}"
+    SKIP_WASM=1
+fi
+for B in ${BENCHES}; do
+    gcc -O2 -o "${SCRIPT_DIR}/${B}_native" "${SCRIPT_DIR}/${B}.c"
+    echo -e "${GREEN}  ✓ Native binary: ${B}_native${NC}"
+    if [ "${SKIP_WASM}" = "0" ]; then
+        "${WALI_CC}" \
+            --target=wasm32-unknown-linux-muslwali \
+            --sysroot="${WALI_SYSROOT}" \
+            -O2 \
+            -pthread \
+            -mcpu=generic \
+            -matomics \
+            -mbulk-memory \
+            -I"${WALI_ROOT}/wali_shims" \
+            -L"${WALI_SYSROOT}/lib" \
+            -Wl,--shared-memory \
+            -Wl,--export-memory \
+            -Wl,--max-memory=2147483648 \
+            -Wl,--allow-undefined \
+            -o "${SCRIPT_DIR}/${B}.wasm" \
+            "${SCRIPT_DIR}/${B}.c"
+        echo -e "${GREEN}  ✓ WASM binary: ${B}.wasm${NC}"
+    fi
+done
+
+echo -e "${YELLOW}[2/2] Running...${NC}"
+for MODE in ${MODES}; do
+    for B in ${BENCHES}; do
+        ARGS="${COPY_ARGS}"
+        [ "${B}" = "perf_batch_echo" ] && ARGS="${ECHO_ARGS}"
+        echo ""
+        echo -e "${BLUE}--- ${B} (${MODE}) ---${NC}"
+        case "${MODE}" in
+            native)
+                "${SCRIPT_DIR}/${B}_native" ${ARGS}
+                ;;
+            interp|fast-jit)
+                if [ "${SKIP_WASM}" = "1" ]; then
+                    echo -e "${YELLOW}  ${MODE}: skipped${NC}"
+                    continue
+                fi
+                "${IWASM}" --${MODE} --env-file="${WALI_ENV}" --dir=/ \
+                    "${SCRIPT_DIR}/${B}.wasm" ${ARGS}
+                ;;
+            *)
+                echo -e "${RED}  Unknown mode: ${MODE}${NC}"
+                ;;
+        esac
+    done
+done
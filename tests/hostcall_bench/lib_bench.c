@@ -0,0 +1,141 @@
+/*
+ * lib_bench.c - No-op host natives for the host-call overhead benchmark
+ *
+ * Registered as "env" natives the same way lib_zlib.c is: build this file
+ * into iwasm next to the other WALI natives and call
+ * wali_bench_register_natives() after wasm_runtime_full_init(). Each
+ * native does the minimum its signature class implies (argument
+ * translation, and for the struct case a field-by-field sync) so that
+ * perf_hostcall.wasm measures the transition and nothing else.
+ *
+ * Signature strings follow NativeSymbol conventions: '*' and '~' make the
+ * runtime validate a pointer/length pair before the call, 'i' passes the
+ * raw app offset, which the native adds to the linear memory base itself,
+ * with no bounds check at all.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "wasm_export.h"
+
+#define NATIVE_FUNC(name, func, sig) { #name, (void *)func, sig, NULL }
+
+/* Must match wali_bench_stream in wali_shims/wali_bench.h */
+typedef struct {
+    uint32_t next_in;
+    uint32_t avail_in;
+    uint32_t total_in;
+    uint32_t next_out;
+    uint32_t avail_out;
+    uint32_t total_out;
+    uint32_t msg;
+    uint32_t state;
+    uint32_t zalloc;
+    uint32_t zfree;
+    uint32_t opaque;
+    int32_t  data_type;
+    uint32_t adler;
+    uint32_t reserved;
+} bench_stream_wasm;
+
+/* Native-side mirror, translated the way lib_zlib.c syncs z_stream */
+typedef struct {
+    const uint8_t *next_in;
+    uint32_t avail_in;
+    uint64_t total_in;
+    uint8_t *next_out;
+    uint32_t avail_out;
+    uint64_t total_out;
+    int data_type;
+    uint64_t adler;
+} bench_stream_native;
+
+static int bench_void_wrapper(wasm_exec_env_t exec_env) {
+    (void)exec_env;
+    return 0;
+}
+
+static int bench_i_wrapper(wasm_exec_env_t exec_env, int a) {
+    (void)exec_env;
+    return a;
+}
+
+static int bench_iiiI_wrapper(wasm_exec_env_t exec_env,
+                              int a, int b, int c, int64_t d) {
+    (void)exec_env;
+    return a + b + c + (int)d;
+}
+
+static int64_t bench_IIII_wrapper(wasm_exec_env_t exec_env,
+                                  int64_t a, int64_t b, int64_t c, int64_t d) {
+    (void)exec_env;
+    return a + b + c + d;
+}
+
+/* Pointers arrive already validated and translated by the runtime */
+static int bench_ptr_checked_wrapper(wasm_exec_env_t exec_env,
+                                     const uint8_t *src, uint32_t src_len,
+                                     uint8_t *dst, uint32_t dst_len) {
+    (void)exec_env;
+    return (src_len ? src[0] : 0) + (dst_len ? dst[0] : 0);
+}
+
+/* App offsets added to the memory base here with no validation:
+ * wasm_runtime_addr_app_to_native would bounds-check each of them */
+static int bench_ptr_raw_wrapper(wasm_exec_env_t exec_env,
+                                 uint32_t src_app, uint32_t src_len,
+                                 uint32_t dst_app, uint32_t dst_len) {
+    wasm_memory_inst_t mem = wasm_runtime_get_default_memory(get_module_inst(exec_env));
+    uint8_t *base = wasm_memory_get_base_address(mem);
+    const uint8_t *src = base + src_app;
+    uint8_t *dst = base + dst_app;
+
+    return (src_len ? src[0] : 0) + (dst_len ? dst[0] : 0);
+}
+
+/* Guest -> native -> guest sync of every field, as a stream call does */
+static int bench_struct_wrapper(wasm_exec_env_t exec_env, uint32_t s_app) {
+    wasm_module_inst_t inst = get_module_inst(exec_env);
+    bench_stream_wasm *s;
+    bench_stream_native n;
+
+    if (!wasm_runtime_validate_app_addr(inst, s_app, sizeof(*s))) {
+        return -1;
+    }
+    s = wasm_runtime_addr_app_to_native(inst, s_app);
+
+    n.next_in = s->next_in ? wasm_runtime_addr_app_to_native(inst, s->next_in) : NULL;
+    n.avail_in = s->avail_in;
+    n.total_in = s->total_in;
+    n.next_out = s->next_out ? wasm_runtime_addr_app_to_native(inst, s->next_out) : NULL;
+    n.avail_out = s->avail_out;
+    n.total_out = s->total_out;
+    n.data_type = s->data_type;
+    n.adler = s->adler;
+
+    s->next_in = n.next_in ? wasm_runtime_addr_native_to_app(inst, (void *)n.next_in) : 0;
+    s->avail_in = n.avail_in;
+    s->total_in = (uint32_t)n.total_in;
+    s->next_out = n.next_out ? wasm_runtime_addr_native_to_app(inst, n.next_out) : 0;
+    s->avail_out = n.avail_out;
+    s->total_out = (uint32_t)n.total_out;
+    s->data_type = n.data_type;
+    s->adler = (uint32_t)n.adler;
+    return 0;
+}
+
+static NativeSymbol native_symbols_bench[] = {
+    NATIVE_FUNC(wali_bench_void, bench_void_wrapper, "()i"),
+    NATIVE_FUNC(wali_bench_i, bench_i_wrapper, "(i)i"),
+    NATIVE_FUNC(wali_bench_iiiI, bench_iiiI_wrapper, "(iiiI)i"),
+    NATIVE_FUNC(wali_bench_IIII, bench_IIII_wrapper, "(IIII)I"),
+    NATIVE_FUNC(wali_bench_ptr_checked, bench_ptr_checked_wrapper, "(*~*~)i"),
+    NATIVE_FUNC(wali_bench_ptr_raw, bench_ptr_raw_wrapper, "(iiii)i"),
+    NATIVE_FUNC(wali_bench_struct, bench_struct_wrapper, "(i)i"),
+};
+
+int wali_bench_register_natives(void) {
+    return wasm_runtime_register_natives("env", native_symbols_bench,
+                                         sizeof(native_symbols_bench) / sizeof(NativeSymbol));
+}
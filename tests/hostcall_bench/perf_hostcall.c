@@ -0,0 +1,154 @@
+/**
+ * Host-Call Overhead Benchmark
+ *
+ * Measures the cost of one guest -> host transition for each import
+ * signature class, using the no-op natives in lib_bench.c, plus a WALI
+ * syscall (wali.SYS_getppid) and an ordinary guest call as references.
+ * Dividing a bridged API's per-call cost by these figures shows how much
+ * of it is transition; when that share is large, batching pays off.
+ *
+ * Cases:
+ *   guest          non-inlined call inside the module (baseline)
+ *   void           "()i"
+ *   i              "(i)i"
+ *   iiiI           "(iiiI)i"          wali_compress shape
+ *   IIII           "(IIII)I"          64-bit arguments
+ *   ptr_checked    "(*~*~)i"          runtime validates both buffers
+ *   ptr_raw        "(iiii)i"          native adds offsets to memory base, no checks
+ *   struct         "(i)i"             validate + sync a 14-field struct
+ *   syscall        wali.SYS_getppid
+ *
+ * Native builds call local no-op functions, so the native column is the
+ * cost of an ordinary call (and a real syscall).
+ *
+ * Usage: perf_hostcall [--csv] [calls]    (default: 10000000 calls per case)
+ *
+ * Compile native:
+ *   gcc -O2 -o perf_hostcall_native perf_hostcall.c
+ *
+ * Compile WASM:
+ *   ./run_hostcall_bench.sh builds it along with the AOT module
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#define DEFAULT_CALLS 10000000L
+#define BUF_SIZE 4096
+
+#ifdef __wasm__
+#include "wali_bench.h"
+#else
+/* Plain calls stand in for the imports on native builds */
+typedef struct {
+    uint32_t next_in, avail_in, total_in, next_out, avail_out;
+} wali_bench_stream;
+
+#define NOINLINE __attribute__((noinline))
+NOINLINE int wali_bench_void(void) { return 0; }
+NOINLINE int wali_bench_i(int a) { return a; }
+NOINLINE int wali_bench_iiiI(int a, int b, int c, int64_t d) { return a + b + c + (int)d; }
+NOINLINE int64_t wali_bench_IIII(int64_t a, int64_t b, int64_t c, int64_t d) { return a + b + c + d; }
+NOINLINE int wali_bench_ptr_checked(const void *src, uint32_t src_len, void *dst, uint32_t dst_len) {
+    return (src_len ? *(const uint8_t *)src : 0) + (dst_len ? *(uint8_t *)dst : 0);
+}
+NOINLINE int wali_bench_ptr_raw(const void *src, uint32_t src_len, void *dst, uint32_t dst_len) {
+    return wali_bench_ptr_checked(src, src_len, dst, dst_len);
+}
+NOINLINE int wali_bench_struct(wali_bench_stream *strm) { strm->total_in += 0; return 0; }
+#endif
+
+__attribute__((noinline)) static int guest_call(int a) {
+    return a;
+}
+
+static double get_time_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static unsigned char src_buf[BUF_SIZE];
+static unsigned char dst_buf[BUF_SIZE];
+static wali_bench_stream stream;
+static volatile int64_t sink;
+
+/* One loop per case so the call site is a direct call in every runtime */
+#define TIME_CASE(name, sig, expr) do {                                 \
+        double start = get_time_ns();                                   \
+        for (long i = 0; i < calls; i++) {                              \
+            sink += (expr);                                             \
+        }                                                               \
+        report(name, sig, (get_time_ns() - start) / calls, csv);        \
+    } while (0)
+
+static void report(const char *name, const char *sig, double ns, int csv) {
+    if (csv) {
+        printf("%s,%s,%.2f\n", name, sig, ns);
+    } else {
+        printf("  %-12s %-12s %10.2f ns/call\n", name, sig, ns);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    long calls = DEFAULT_CALLS;
+    int csv = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            csv = 1;
+        } else {
+            calls = atol(argv[i]);
+        }
+    }
+    if (calls <= 0) {
+        printf("Invalid call count\n");
+        return 1;
+    }
+
+    stream.next_in = (uint32_t)(uintptr_t)src_buf;
+    stream.avail_in = BUF_SIZE;
+    stream.next_out = (uint32_t)(uintptr_t)dst_buf;
+    stream.avail_out = BUF_SIZE;
+
+    if (csv) {
+        printf("case,signature,ns_per_call\n");
+    } else {
+        printf("==================================================\n");
+        printf("  Host-Call Overhead Benchmark\n");
+#ifdef __wasm__
+        printf("  Platform: WebAssembly (WALI)\n");
+#else
+        printf("  Platform: Native\n");
+#endif
+        printf("  %ld calls per case\n", calls);
+        printf("==================================================\n\n");
+    }
+
+    /* Warm-up: resolve imports and let tiering JITs compile the loops */
+    for (long i = 0; i < calls / 10; i++) {
+        sink += wali_bench_void() + guest_call((int)i);
+    }
+
+    TIME_CASE("guest", "-", guest_call((int)i));
+    TIME_CASE("void", "()i", wali_bench_void());
+    TIME_CASE("i", "(i)i", wali_bench_i((int)i));
+    TIME_CASE("iiiI", "(iiiI)i", wali_bench_iiiI((int)i, 2, 3, (int64_t)i));
+    TIME_CASE("IIII", "(IIII)I", wali_bench_IIII(i, 2, 3, 4));
+    TIME_CASE("ptr_checked", "(*~*~)i", wali_bench_ptr_checked(src_buf, BUF_SIZE, dst_buf, BUF_SIZE));
+    TIME_CASE("ptr_raw", "(iiii)i", wali_bench_ptr_raw(src_buf, BUF_SIZE, dst_buf, BUF_SIZE));
+    TIME_CASE("struct", "(i)i", wali_bench_struct(&stream));
+    TIME_CASE("syscall", "SYS_getppid", syscall(SYS_getppid));
+
+    if (!csv) {
+        printf("\n==================================================\n");
+        printf("  Host-call benchmark complete!\n");
+        printf("==================================================\n");
+    }
+    return 0;
+}
@@ -0,0 +1,141 @@
+#!/bin/bash
+# run_hostcall_bench.sh - Measure host-call overhead per signature class
+#
+# This script:
+# 1. Compiles perf_hostcall.c natively and for WASM (and AOT with wamrc)
+# 2. Runs it natively and under iwasm --interp, --fast-jit and AOT
+# 3. Prints one ns/call column per runtime mode
+#
+# iwasm must be built with lib_bench.c registered (see the top of that
+# file); without it the WASM runs fail to link the wali_bench_* imports.
+#
+# Settings:
+#   MODES   runtime modes, default "native interp fast-jit aot"
+#   CALLS   calls per case (default: 10000000; use less for interp)
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+WALI_ROOT="${SCRIPT_DIR}/../.."
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+BLUE='\033[0;34m'
+CYAN='\033[0;36m'
+NC='\033[0m' # No Color
+
+SRC="${SCRIPT_DIR}/perf_hostcall.c"
+NATIVE_BIN="${SCRIPT_DIR}/perf_hostcall_native"
+WASM_BIN="${SCRIPT_DIR}/perf_hostcall.wasm"
+AOT_BIN="${SCRIPT_DIR}/perf_hostcall.aot"
+IWASM="${WALI_ROOT}/build/wamr/iwasm/iwasm"
+WAMRC="${WAMRC:-${WALI_ROOT}/build/wamr/wamr-compiler/wamrc}"
+WALI_ENV="${WALI_ROOT}/.walienv"
+
+# WALI toolchain
+WALI_CC="${WALI_ROOT}/build/llvm/bin/clang"
+WALI_SYSROOT="${WALI_ROOT}/build/sysroot"
+
+MODES="${MODES:-native interp fast-jit aot}"
+CALLS="${CALLS:-10000000}"
+RESULTS_DIR="$(mktemp -d)"
+trap 'rm -rf "${RESULTS_DIR}"' EXIT
+
+echo -e "${BLUE}╔══════════════════════════════════════════════════════════════╗${NC}"
+echo -e "${BLUE}║         Host-Call Overhead by Signature Class                ║${NC}"
+echo -e "${BLUE}╚══════════════════════════════════════════════════════════════╝${NC}"
+echo ""
+
+echo -e "${YELLOW}[1/3] Compiling...${NC}"
+gcc -O2 -o "${NATIVE_BIN}" "${SRC}"
+echo -e "${GREEN}  ✓ Native binary: ${NATIVE_BIN}${NC}"
+
+SKIP_WASM=0
+SKIP_AOT=0
+if [ ! -f "${WALI_CC}" ] || [ ! -f "${IWASM}" ]; then
+    echo -e "${RED}  ✗ WALI compiler or iwasm not found, skipping WASM modes${NC}"
+    SKIP_WASM=1
+else
+    "${WALI_CC}" \
+        --target=wasm32-unknown-linux-muslwali \
+        --sysroot="${WALI_SYSROOT}" \
+        -O2 \
+        -pthread \
+        -mcpu=generic \
+        -matomics \
+        -mbulk-memory \
+        -I"${WALI_ROOT}/wali_shims" \
+        -L"${WALI_SYSROOT}/lib" \
+        -Wl,--shared-memory \
+        -Wl,--export-memory \
+        -Wl,--max-memory=2147483648 \
+        -Wl,--allow-undefined \
+        -o "${WASM_BIN}" \
+        "${SRC}"
+    echo -e "${GREEN}  ✓ WASM binary: ${WASM_BIN}${NC}"
+
+    if [[ " ${MODES} " == *" aot "* ]]; then
+        if [ -x "${WAMRC}" ]; then
+            "${WAMRC}" --enable-multi-thread -o "${AOT_BIN}" "${WASM_BIN}" > /dev/null
+            echo -e "${GREEN}  ✓ AOT binary: ${AOT_BIN}${NC}"
+        else
+            echo -e "${YELLOW}  wamrc not found at: ${WAMRC}, skipping aot mode${NC}"
+            SKIP_AOT=1
+        fi
+    fi
+fi
+
+echo -e "${YELLOW}[2/3] Running (${CALLS} calls per case)...${NC}"
+RAN=""
+for MODE in ${MODES}; do
+    OUT="${RESULTS_DIR}/${MODE}.csv"
+    case "${MODE}" in
+        native)
+            "${NATIVE_BIN}" --csv "${CALLS}" > "${OUT}"
+            ;;
+        interp|fast-jit|aot)
+            if [ "${SKIP_WASM}" = "1" ] || { [ "${MODE}" = "aot" ] && [ "${SKIP_AOT}" = "1" ]; }; then
+                echo -e "${YELLOW}  ${MODE}: skipped${NC}"
+                continue
+            fi
+            MODULE="${WASM_BIN}"
+            FLAG=""
+            [ "${MODE}" = "interp" ] && FLAG="--interp"
+            [ "${MODE}" = "fast-jit" ] && FLAG="--fast-jit"
+            [ "${MODE}" = "aot" ] && MODULE="${AOT_BIN}"
+            "${IWASM}" ${FLAG} --env-file="${WALI_ENV}" --dir=/ \
+                "${MODULE}" --csv "${CALLS}" > "${OUT}"
+            ;;
+        *)
+            echo -e "${RED}  Unknown mode: ${MODE}${NC}"
+            continue
+            ;;
+    esac
+    echo -e "${CYAN}  ${MODE}: done${NC}"
+    RAN="${RAN} ${MODE}"
+done
+
+echo ""
+echo -e "${YELLOW}[3/3] ns/call by runtime mode${NC}"
+echo ""
+# Join the per-mode CSVs on the case column
+(cd "${RESULTS_DIR}" && awk -F, -v modes="${RAN# }" '
+    BEGIN { n = split(modes, m, " ") }
+    FNR == 1 { file++; next }
+    {
+        if (!($1 in sig)) { order[++rows] = $1; sig[$1] = $2 }
+        ns[$1, file] = $3
+    }
+    END {
+        printf "%-12s %-12s", "case", "signature"
+        for (i = 1; i <= n; i++) printf " %10s", m[i]
+        printf "\n"
+        for (r = 1; r <= rows; r++) {
+            c = order[r]
+            printf "%-12s %-12s", c, sig[c]
+            for (i = 1; i <= n; i++) printf " %10s", ((c, i) in ns) ? ns[c, i] : "-"
+            printf "\n"
+        }
+    }' $(for M in ${RAN}; do echo "${M}.csv"; done))
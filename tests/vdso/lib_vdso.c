@@ -0,0 +1,232 @@
+/*
+ * lib_vdso.c - Host side of the WALI vdso page (wali_shims/wali_vdso.h)
+ *
+ * Registered as a "wali" native the same way lib_batch.c is: build this
+ * file into iwasm and call wali_vdso_register_natives() after
+ * wasm_runtime_full_init(), and wali_vdso_stop() before the module
+ * instance is deinstantiated.
+ *
+ * The page is wali_vdso_storage in the guest's data segment, which the
+ * guest passes to the first wali_vdso_page() call: no heap owns it, so
+ * nothing in the guest can free or reuse it. That call also starts a
+ * ticker thread that republishes the clock snapshot every
+ * WALI_VDSO_TICK_US microseconds (default 1000, the kernel's coarse-clock
+ * granularity at HZ=1000) under a seqlock. Later calls, including from
+ * other guest threads, return the same page: iwasm runs one WALI module
+ * per process, and WALI modules use shared memory, so the page never
+ * moves. The ticker writes into linear memory until wali_vdso_stop() has
+ * joined it. A forked child gets a new pid and fork_gen and its own
+ * ticker before the guest resumes.
+ *
+ * WALI_VDSO_TICK_CLOCKS=1 lets the guest serve CLOCK_REALTIME/MONOTONIC/
+ * BOOTTIME from the snapshot too, trading resolution for the import.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "wasm_export.h"
+
+#define NATIVE_FUNC(name, func, sig) { #name, (void *)func, sig, NULL }
+
+/* Must match wali_shims/wali_vdso.h */
+#define WALI_VDSO_MAGIC         0x4f534457u
+#define WALI_VDSO_VERSION       1
+#define WALI_VDSO_TICK_CLOCKS   1
+
+typedef struct {
+    int64_t sec;
+    int64_t nsec;
+} vdso_ts;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t flags;
+    uint32_t seq;
+    int64_t  tick_ns;
+    vdso_ts  realtime;
+    vdso_ts  monotonic;
+    vdso_ts  boottime;
+    int32_t  pid;
+    uint32_t fork_gen;
+} wali_vdso_data_wasm;
+
+/* vdso_lock guards everything below; vdso_cond wakes the ticker early */
+static pthread_mutex_t vdso_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t vdso_cond;
+static pthread_once_t vdso_init_once = PTHREAD_ONCE_INIT;
+static wali_vdso_data_wasm *vdso_page;
+static uint32_t vdso_page_app;
+static struct timespec vdso_tick;
+static pthread_t vdso_ticker_tid;
+static int vdso_stopping;
+
+static void snap(clockid_t clk, vdso_ts *dst) {
+    struct timespec ts;
+    clock_gettime(clk, &ts);
+    dst->sec = ts.tv_sec;
+    dst->nsec = ts.tv_nsec;
+}
+
+static void vdso_publish(wali_vdso_data_wasm *d) {
+    uint32_t seq = d->seq;
+    __atomic_store_n(&d->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    snap(CLOCK_REALTIME, &d->realtime);
+    snap(CLOCK_MONOTONIC, &d->monotonic);
+    snap(CLOCK_BOOTTIME, &d->boottime);
+    __atomic_store_n(&d->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+/* Sleeps on vdso_cond rather than clock_nanosleep so wali_vdso_stop()
+ * does not have to wait out a long tick */
+static void *vdso_ticker(void *arg) {
+    wali_vdso_data_wasm *d = arg;
+    struct timespec next;
+
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    pthread_mutex_lock(&vdso_lock);
+    while (!vdso_stopping) {
+        next.tv_nsec += vdso_tick.tv_nsec;
+        next.tv_sec += vdso_tick.tv_sec + next.tv_nsec / 1000000000;
+        next.tv_nsec %= 1000000000;
+        while (!vdso_stopping
+               && pthread_cond_timedwait(&vdso_cond, &vdso_lock, &next) != ETIMEDOUT) {
+        }
+        if (!vdso_stopping) {
+            vdso_publish(d);
+        }
+    }
+    pthread_mutex_unlock(&vdso_lock);
+    return NULL;
+}
+
+static void vdso_cond_init(void) {
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&vdso_cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+/* Holding vdso_lock across fork keeps the ticker out of vdso_publish, so
+ * the child never inherits a page with an odd seq */
+static void vdso_atfork_prepare(void) {
+    pthread_mutex_lock(&vdso_lock);
+}
+
+static void vdso_atfork_parent(void) {
+    pthread_mutex_unlock(&vdso_lock);
+}
+
+/* Threads do not survive fork: refresh the page and restart the ticker */
+static void vdso_atfork_child(void) {
+    vdso_cond_init();
+    if (vdso_page && vdso_stopping) {
+        /* Forked while wali_vdso_stop() was joining: nothing to restart */
+        vdso_page = NULL;
+        vdso_page_app = 0;
+    } else if (vdso_page) {
+        vdso_page->pid = (int32_t)getpid();
+        vdso_page->fork_gen++;
+        vdso_publish(vdso_page);
+        if (pthread_create(&vdso_ticker_tid, NULL, vdso_ticker, vdso_page) != 0) {
+            /* Clock fields would go stale: have the guest use syscalls */
+            vdso_page->magic = 0;
+            vdso_page = NULL;
+            vdso_page_app = 0;
+        }
+    }
+    pthread_mutex_unlock(&vdso_lock);
+}
+
+static void vdso_init(void) {
+    vdso_cond_init();
+    pthread_atfork(vdso_atfork_prepare, vdso_atfork_parent, vdso_atfork_child);
+}
+
+static uint32_t vdso_page_wrapper(wasm_exec_env_t exec_env, uint32_t app, uint32_t size) {
+    wasm_module_inst_t inst = get_module_inst(exec_env);
+    wali_vdso_data_wasm *d;
+    const char *env;
+    uint64_t tick_us = 1000;
+
+    pthread_once(&vdso_init_once, vdso_init);
+    pthread_mutex_lock(&vdso_lock);
+    if (vdso_page) {
+        app = vdso_page_app;
+        goto out;
+    }
+    if (size != sizeof(*d) || (app & 7) || !wasm_runtime_validate_app_addr(inst, app, size)) {
+        app = 0;
+        goto out;
+    }
+    d = wasm_runtime_addr_app_to_native(inst, app);
+    if ((env = getenv("WALI_VDSO_TICK_US")) && atoll(env) > 0) {
+        tick_us = (uint64_t)atoll(env);
+    }
+    vdso_tick.tv_sec = (time_t)(tick_us / 1000000);
+    vdso_tick.tv_nsec = (long)(tick_us % 1000000) * 1000;
+
+    memset(d, 0, sizeof(*d));
+    d->magic = WALI_VDSO_MAGIC;
+    d->version = WALI_VDSO_VERSION;
+    d->tick_ns = (int64_t)tick_us * 1000;
+    d->pid = (int32_t)getpid();
+    if ((env = getenv("WALI_VDSO_TICK_CLOCKS")) && atoi(env) == 1) {
+        d->flags |= WALI_VDSO_TICK_CLOCKS;
+    }
+    vdso_publish(d);
+    vdso_stopping = 0;
+    if (pthread_create(&vdso_ticker_tid, NULL, vdso_ticker, d) != 0) {
+        /* A stale page is worse than none: the guest falls back to syscalls */
+        d->magic = 0;
+        app = 0;
+        goto out;
+    }
+    vdso_page = d;
+    vdso_page_app = app;
+
+out:
+    pthread_mutex_unlock(&vdso_lock);
+    return app;
+}
+
+/* Stops and joins the ticker; after this the host no longer touches the
+ * page. Call it before deinstantiating the module instance that owns it.
+ * A later instance gets a fresh page on its first wali_vdso_page call. */
+void wali_vdso_stop(void) {
+    pthread_t tid;
+
+    pthread_mutex_lock(&vdso_lock);
+    if (!vdso_page) {
+        pthread_mutex_unlock(&vdso_lock);
+        return;
+    }
+    tid = vdso_ticker_tid;
+    vdso_stopping = 1;
+    pthread_cond_signal(&vdso_cond);
+    pthread_mutex_unlock(&vdso_lock);
+
+    pthread_join(tid, NULL);
+
+    pthread_mutex_lock(&vdso_lock);
+    vdso_page = NULL;
+    vdso_page_app = 0;
+    pthread_mutex_unlock(&vdso_lock);
+}
+
+static NativeSymbol native_symbols_vdso[] = {
+    NATIVE_FUNC(wali_vdso_page, vdso_page_wrapper, "(ii)i"),
+};
+
+int wali_vdso_register_natives(void) {
+    return wasm_runtime_register_natives("wali", native_symbols_vdso,
+                                         sizeof(native_symbols_vdso) / sizeof(NativeSymbol));
+}
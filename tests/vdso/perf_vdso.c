@@ -0,0 +1,92 @@
+/**
+ * vdso Page Benchmark
+ *
+ * Compares the cost of the calls the vdso page (wali_shims/wali_vdso.h)
+ * can serve with the syscalls they replace. The syscall
+ * and libc rows run everywhere; the page readers are only timed in WASM
+ * builds made with -DWALI_VDSO, run by an iwasm that has lib_vdso.c
+ * registered.
+ *
+ * Rows:
+ *   clock_gettime(MONOTONIC)     libc
+ *   clock_gettime(MONO_COARSE)   libc
+ *   SYS_clock_gettime            always the syscall
+ *   getpid / SYS_gettid          libc and the raw syscall
+ *   vdso ...                     the page readers directly
+ *
+ * Usage: perf_vdso [iterations]    (default: 200000 calls per row)
+ *
+ * Compile native:
+ *   gcc -O2 -o perf_vdso_native perf_vdso.c
+ *
+ * Compile WASM:
+ *   the flags from tests/writev_bench/run_writev_bench.sh, plus
+ *   -I../../wali_shims -DWALI_VDSO
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#if defined(__wasm__) && defined(WALI_VDSO)
+#include "wali_vdso.h"
+#endif
+
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+#define TIME_LOOP(name, stmt) {                                             \
+    int64_t start = now_ns();                                               \
+    for (long i = 0; i < iters; i++) {                                      \
+        stmt;                                                               \
+    }                                                                       \
+    printf("  %-28s %8.1f ns/call\n", name, (double)(now_ns() - start) / iters); \
+}
+
+int main(int argc, char *argv[]) {
+    long iters = argc > 1 ? atol(argv[1]) : 200000;
+    struct timespec ts;
+    volatile long sink = 0;
+
+    if (iters <= 0) {
+        printf("Usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    printf("==================================================\n");
+    printf("  vdso Page Benchmark\n");
+#if defined(__wasm__) && defined(WALI_VDSO)
+    printf("  Platform: WebAssembly (WALI), vdso page %s\n", wali_vdso_get() ? "present" : "absent");
+#elif defined(__wasm__)
+    printf("  Platform: WebAssembly (WALI), built without WALI_VDSO\n");
+#else
+    printf("  Platform: Native\n");
+#endif
+    printf("  %ld calls per row\n", iters);
+    printf("==================================================\n\n");
+
+    TIME_LOOP("clock_gettime(MONOTONIC)", clock_gettime(CLOCK_MONOTONIC, &ts); sink += ts.tv_nsec);
+    TIME_LOOP("clock_gettime(MONO_COARSE)", clock_gettime(CLOCK_MONOTONIC_COARSE, &ts); sink += ts.tv_nsec);
+    TIME_LOOP("SYS_clock_gettime", syscall(SYS_clock_gettime, CLOCK_MONOTONIC, &ts); sink += ts.tv_nsec);
+    TIME_LOOP("getpid", sink += getpid());
+    TIME_LOOP("SYS_gettid", sink += syscall(SYS_gettid));
+#if defined(__wasm__) && defined(WALI_VDSO)
+    if (wali_vdso_get()) {
+        TIME_LOOP("vdso clock(MONO_COARSE)", wali_vdso_clock_gettime(CLOCK_MONOTONIC_COARSE, &ts); sink += ts.tv_nsec);
+        TIME_LOOP("vdso getpid", sink += wali_vdso_getpid());
+        TIME_LOOP("vdso gettid", sink += wali_vdso_gettid());
+    }
+#endif
+    (void)sink;
+
+    printf("\n==================================================\n");
+    printf("  vdso benchmark complete!\n");
+    printf("==================================================\n");
+    return 0;
+}
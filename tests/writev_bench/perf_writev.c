@@ -0,0 +1,111 @@
+/**
+ * writev Translation Benchmark
+ *
+ * Calls writev() with 1 to 64 iovecs, each segment seg_size bytes, in two
+ * layouts: contiguous (adjacent slices of one buffer) and scattered (one
+ * cache line apart). Under WALI every call widens the wasm32 iovec array
+ * (iovec.h); contiguous vectors are merged into a single host segment,
+ * scattered ones are not, so the difference between the two columns is
+ * the per-segment cost on either side of the boundary. Writing to
+ * /dev/null keeps the kernel's share of the call small.
+ *
+ * Tests:
+ * 1. contiguous  - iov[i].iov_base = buf + i * seg_size
+ * 2. scattered   - iov[i].iov_base = buf + i * (seg_size + GAP)
+ *
+ * Usage: perf_writev [iterations] [seg_size] [path]
+ *        (default: 200000 calls per case, 64-byte segments, /dev/null)
+ *
+ * Compile native:
+ *   gcc -O2 -o perf_writev_native perf_writev.c
+ *
+ * Compile WASM:
+ *   ./run_writev_bench.sh builds it
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#define MAX_IOV 64
+#define GAP 64
+
+static double get_time_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static double run_case(int fd, char *buf, int iovcnt, size_t seg, int scattered, long iters) {
+    struct iovec iov[MAX_IOV];
+    ssize_t expect = (ssize_t)(iovcnt * seg);
+    double start;
+
+    for (int i = 0; i < iovcnt; i++) {
+        iov[i].iov_base = buf + i * (scattered ? seg + GAP : seg);
+        iov[i].iov_len = seg;
+    }
+    start = get_time_ns();
+    for (long n = 0; n < iters; n++) {
+        if (writev(fd, iov, iovcnt) != expect) {
+            return -1;
+        }
+    }
+    return (get_time_ns() - start) / iters;
+}
+
+int main(int argc, char *argv[]) {
+    static const int counts[] = { 1, 2, 4, 8, 16, 32, 64 };
+    long iters = argc > 1 ? atol(argv[1]) : 200000;
+    long seg = argc > 2 ? atol(argv[2]) : 64;
+    const char *path = argc > 3 ? argv[3] : "/dev/null";
+    char *buf;
+    int fd, ret = 1;
+
+    if (iters <= 0 || seg <= 0 || seg > 65536) {
+        printf("Usage: %s [iterations] [seg_size <= 65536] [path]\n", argv[0]);
+        return 1;
+    }
+
+    printf("==================================================\n");
+    printf("  writev Translation Benchmark\n");
+#ifdef __wasm__
+    printf("  Platform: WebAssembly (WALI)\n");
+#else
+    printf("  Platform: Native\n");
+#endif
+    printf("  %ld calls per case, %ld-byte segments, %s\n", iters, seg, path);
+    printf("==================================================\n\n");
+
+    buf = malloc((size_t)MAX_IOV * (seg + GAP));
+    if (!buf || (fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0) {
+        printf("Could not set up %s\n", path);
+        free(buf);
+        return 1;
+    }
+    memset(buf, 'w', (size_t)MAX_IOV * (seg + GAP));
+
+    printf("  %6s  %14s  %14s  %14s\n", "iovcnt", "contiguous", "scattered", "ns/iovec (sc)");
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        double contig = run_case(fd, buf, counts[c], (size_t)seg, 0, iters);
+        double scat = run_case(fd, buf, counts[c], (size_t)seg, 1, iters);
+        if (contig < 0 || scat < 0) {
+            printf("  [%d] writev failed\n", counts[c]);
+            goto cleanup;
+        }
+        printf("  %6d  %11.1f ns  %11.1f ns  %14.1f\n", counts[c], contig, scat, scat / counts[c]);
+    }
+    ret = 0;
+
+cleanup:
+    close(fd);
+    free(buf);
+    printf("\n==================================================\n");
+    printf("  writev benchmark complete!\n");
+    printf("==================================================\n");
+    return ret;
+}
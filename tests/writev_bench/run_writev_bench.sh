@@ -0,0 +1,89 @@
+#!/bin/bash
+# run_writev_bench.sh - writev cost for 1-64 iovecs, contiguous vs scattered
+#
+# This script:
+# 1. Compiles perf_writev.c natively and for WASM
+# 2. Runs it natively and under iwasm in each runtime mode
+#
+# The WASM columns include the wasm32 iovec widening in the WALI writev
+# stub (iovec.h generated by scripts/autogen.py); compare them with the
+# native column for the translation cost per call and per segment.
+#
+# Settings:
+#   MODES   runtime modes, default "native interp fast-jit"
+#   ARGS    perf_writev arguments (default: "200000 64 /dev/null")
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+WALI_ROOT="${SCRIPT_DIR}/../.."
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+BLUE='\033[0;34m'
+NC='\033[0m' # No Color
+
+IWASM="${WALI_ROOT}/build/wamr/iwasm/iwasm"
+WALI_ENV="${WALI_ROOT}/.walienv"
+
+# WALI toolchain
+WALI_CC="${WALI_ROOT}/build/llvm/bin/clang"
+WALI_SYSROOT="${WALI_ROOT}/build/sysroot"
+
+MODES="${MODES:-native interp fast-jit}"
+ARGS="${ARGS:-200000 64 /dev/null}"
+
+echo -e "${BLUE}╔══════════════════════════════════════════════════════════════╗${NC}"
+echo -e "${BLUE}║         writev iovec Translation Benchmark                   ║${NC}"
+echo -e "${BLUE}╚══════════════════════════════════════════════════════════════╝${NC}"
+echo ""
+
+echo -e "${YELLOW}[1/2] Compiling...${NC}"
+SKIP_WASM=0
+if [ ! -f "${WALI_CC}" ] || [ ! -f "${IWASM}" ]; then
+    echo -e "${RED}  ✗ WALI compiler or iwasm not found, skipping WASM modes${NC}"
+    SKIP_WASM=1
+fi
+gcc -O2 -o "${SCRIPT_DIR}/perf_writev_native" "${SCRIPT_DIR}/perf_writev.c"
+echo -e "${GREEN}  ✓ Native binary: perf_writev_native${NC}"
+if [ "${SKIP_WASM}" = "0" ]; then
+    "${WALI_CC}" \
+        --target=wasm32-unknown-linux-muslwali \
+        --sysroot="${WALI_SYSROOT}" \
+        -O2 \
+        -pthread \
+        -mcpu=generic \
+        -matomics \
+        -mbulk-memory \
+        -L"${WALI_SYSROOT}/lib" \
+        -Wl,--shared-memory \
+        -Wl,--export-memory \
+        -Wl,--max-memory=2147483648 \
+        -o "${SCRIPT_DIR}/perf_writev.wasm" \
+        "${SCRIPT_DIR}/perf_writev.c"
+    echo -e "${GREEN}  ✓ WASM binary: perf_writev.wasm${NC}"
+fi
+
+echo -e "${YELLOW}[2/2] Running...${NC}"
+for MODE in ${MODES}; do
+    echo ""
+    echo -e "${BLUE}--- perf_writev (${MODE}) ---${NC}"
+    case "${MODE}" in
+        native)
+            "${SCRIPT_DIR}/perf_writev_native" ${ARGS}
+            ;;
+        interp|fast-jit)
+            if [ "${SKIP_WASM}" = "1" ]; then
+                echo -e "${YELLOW}  ${MODE}: skipped${NC}"
+                continue
+            fi
+            "${IWASM}" --${MODE} --env-file="${WALI_ENV}" --dir=/ \
+                "${SCRIPT_DIR}/perf_writev.wasm" ${ARGS}
+            ;;
+        *)
+            echo -e "${RED}  Unknown mode: ${MODE}${NC}"
+            ;;
+    esac
+done
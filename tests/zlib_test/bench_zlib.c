@@ -0,0 +1,490 @@
+/**
+ * zlib Benchmark Harness
+ *
+ * One program for every runtime: the same cases are built natively and
+ * for WALI, and run_perf_test.sh runs the WASM build under the
+ * interpreter, AOT and fast JIT. Each case is calibrated to a minimum
+ * run time, warmed up, then timed over several repetitions; results carry
+ * the mean, standard deviation and 95% confidence interval so that
+ * compare_bench.py can tell a regression from noise.
+ *
+ * Cases:    compress, uncompress, deflate, inflate, crc32, adler32
+ * Patterns: text (repetitive ASCII), random (incompressible), zeros
+ * Sizes:    1 KB, 64 KB, 1 MB
+ *
+ * Usage: bench_zlib [options]
+ *   --format text|csv|json   output format (default: text)
+ *   --reps N                 timed repetitions per case (default: 10)
+ *   --warmup N               untimed repetitions per case (default: 2)
+ *   --min-time MS            minimum duration of one repetition (default: 20)
+ *   --filter STR             only run cases whose name contains STR
+ *   --runtime NAME           runtime label in the output (default: native/wasm)
+ *   --backend NAME           zlib label recorded with the results (default:
+ *                            "zlib-ng" if zlibVersion() says so, else "zlib")
+ *
+ * Compile native:
+ *   gcc -O2 -o bench_zlib_native bench_zlib.c -lz -lm
+ *
+ * Compile WASM:
+ *   ./compile.sh bench_zlib
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include <zlib.h>
+
+#define MAX_REPS 100
+#define MAX_ITERS (1 << 24)
+
+typedef enum { FMT_TEXT, FMT_CSV, FMT_JSON } Format;
+
+typedef struct {
+    const unsigned char *src;
+    size_t size;
+    unsigned char *comp;
+    uLong comp_len;
+    unsigned char *out;
+    uLong out_cap;
+    z_stream def;
+    z_stream inf;
+} Ctx;
+
+typedef struct {
+    const char *name;
+    int (*run)(Ctx *ctx, long iters);
+} Case;
+
+typedef struct {
+    const char *name;
+    void (*fill)(unsigned char *buf, size_t size);
+} Pattern;
+
+typedef struct {
+    double mean;
+    double stddev;
+    double ci95;
+    double ns_per_op;
+    long iters;
+} Stats;
+
+static struct {
+    Format format;
+    int reps;
+    int warmup;
+    double min_time_ms;
+    const char *filter;
+    const char *runtime;
+    const char *backend;
+} opts = { FMT_TEXT, 10, 2, 20.0, NULL, NULL, NULL };
+
+static const size_t sizes[] = { 1024, 65536, 1048576 };
+
+static double get_time_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/* ---- Data patterns ---- */
+
+static void fill_text(unsigned char *buf, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        buf[i] = (unsigned char)((i * 7 + i / 13) % 95 + 32);
+    }
+}
+
+static void fill_random(unsigned char *buf, size_t size) {
+    uint32_t state = 12345;
+    for (size_t i = 0; i < size; i++) {
+        state = state * 1103515245u + 12345u;
+        buf[i] = (unsigned char)(state >> 16);
+    }
+}
+
+static void fill_zeros(unsigned char *buf, size_t size) {
+    memset(buf, 0, size);
+}
+
+static const Pattern patterns[] = {
+    { "text", fill_text },
+    { "random", fill_random },
+    { "zeros", fill_zeros },
+};
+
+/* ---- Cases: each runs its operation iters times, 0 on failure ---- */
+
+static int run_compress(Ctx *ctx, long iters) {
+    for (long i = 0; i < iters; i++) {
+        uLongf len = ctx->out_cap;
+        if (compress2(ctx->out, &len, ctx->src, ctx->size, Z_DEFAULT_COMPRESSION) != Z_OK) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int run_uncompress(Ctx *ctx, long iters) {
+    for (long i = 0; i < iters; i++) {
+        uLongf len = ctx->out_cap;
+        if (uncompress(ctx->out, &len, ctx->comp, ctx->comp_len) != Z_OK || len != ctx->size) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Streaming cases keep one stream open and reset it, as servers do */
+static int run_deflate(Ctx *ctx, long iters) {
+    for (long i = 0; i < iters; i++) {
+        deflateReset(&ctx->def);
+        ctx->def.next_in = (Bytef *)ctx->src;
+        ctx->def.avail_in = ctx->size;
+        ctx->def.next_out = ctx->out;
+        ctx->def.avail_out = ctx->out_cap;
+        if (deflate(&ctx->def, Z_FINISH) != Z_STREAM_END) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int run_inflate(Ctx *ctx, long iters) {
+    for (long i = 0; i < iters; i++) {
+        inflateReset(&ctx->inf);
+        ctx->inf.next_in = ctx->comp;
+        ctx->inf.avail_in = ctx->comp_len;
+        ctx->inf.next_out = ctx->out;
+        ctx->inf.avail_out = ctx->out_cap;
+        if (inflate(&ctx->inf, Z_FINISH) != Z_STREAM_END) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static volatile uLong sink;
+
+static int run_crc32(Ctx *ctx, long iters) {
+    for (long i = 0; i < iters; i++) {
+        sink = crc32(sink, ctx->src, ctx->size);
+    }
+    return 1;
+}
+
+static int run_adler32(Ctx *ctx, long iters) {
+    for (long i = 0; i < iters; i++) {
+        sink = adler32(sink, ctx->src, ctx->size);
+    }
+    return 1;
+}
+
+static const Case cases[] = {
+    { "compress", run_compress },
+    { "uncompress", run_uncompress },
+    { "deflate", run_deflate },
+    { "inflate", run_inflate },
+    { "crc32", run_crc32 },
+    { "adler32", run_adler32 },
+};
+
+/* ---- Statistics ---- */
+
+/* Two-sided 95% Student t quantiles for 1..30 degrees of freedom */
+static const double t95[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+};
+
+static void compute_stats(const double *mbps, int n, Stats *st) {
+    double sum = 0, var = 0;
+
+    for (int i = 0; i < n; i++) {
+        sum += mbps[i];
+    }
+    st->mean = sum / n;
+    for (int i = 0; i < n; i++) {
+        var += (mbps[i] - st->mean) * (mbps[i] - st->mean);
+    }
+    st->stddev = n > 1 ? sqrt(var / (n - 1)) : 0;
+    st->ci95 = n > 1 ? (n - 1 <= 30 ? t95[n - 2] : 1.96) * st->stddev / sqrt(n) : 0;
+}
+
+/* Double the iteration count until one repetition lasts min_time_ms */
+static long calibrate(const Case *c, Ctx *ctx) {
+    long iters = 1;
+
+    for (;;) {
+        double start = get_time_ms();
+        if (!c->run(ctx, iters)) {
+            return 0;
+        }
+        if (get_time_ms() - start >= opts.min_time_ms || iters >= MAX_ITERS) {
+            return iters;
+        }
+        iters *= 2;
+    }
+}
+
+static int measure(const Case *c, Ctx *ctx, Stats *st) {
+    double mbps[MAX_REPS];
+    double total_ms = 0;
+    long iters = calibrate(c, ctx);
+
+    if (iters == 0) {
+        return 0;
+    }
+    for (int i = 0; i < opts.warmup; i++) {
+        if (!c->run(ctx, iters)) {
+            return 0;
+        }
+    }
+    for (int i = 0; i < opts.reps; i++) {
+        double start = get_time_ms(), elapsed;
+        if (!c->run(ctx, iters)) {
+            return 0;
+        }
+        elapsed = get_time_ms() - start;
+        total_ms += elapsed;
+        mbps[i] = (ctx->size * (double)iters / 1048576.0) / (elapsed / 1000.0);
+    }
+    compute_stats(mbps, opts.reps, st);
+    st->iters = iters;
+    st->ns_per_op = total_ms * 1e6 / ((double)iters * opts.reps);
+    return 1;
+}
+
+/* ---- Setup ---- */
+
+static int setup(Ctx *ctx, const unsigned char *src, size_t size) {
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->src = src;
+    ctx->size = size;
+    ctx->out_cap = compressBound(size);
+    ctx->comp = malloc(ctx->out_cap);
+    ctx->out = malloc(ctx->out_cap);
+    ctx->comp_len = ctx->out_cap;
+
+    if (!ctx->comp || !ctx->out ||
+        compress2(ctx->comp, &ctx->comp_len, src, size, Z_DEFAULT_COMPRESSION) != Z_OK ||
+        deflateInit(&ctx->def, Z_DEFAULT_COMPRESSION) != Z_OK ||
+        inflateInit(&ctx->inf) != Z_OK) {
+        return 0;
+    }
+
+    /* Round trip once so a broken runtime cannot report fast numbers */
+    {
+        uLongf len = ctx->out_cap;
+        if (uncompress(ctx->out, &len, ctx->comp, ctx->comp_len) != Z_OK ||
+            len != size || memcmp(ctx->out, src, size) != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void teardown(Ctx *ctx) {
+    deflateEnd(&ctx->def);
+    inflateEnd(&ctx->inf);
+    free(ctx->comp);
+    free(ctx->out);
+}
+
+/* ---- Output ---- */
+
+static int first_result = 1;
+
+/* Labels come from the command line, so quote and escape them for JSON */
+static void print_json_string(const char *s) {
+    putchar('"');
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            printf("\\%c", c);
+        } else if (c < 0x20) {
+            printf("\\u%04x", c);
+        } else {
+            putchar(c);
+        }
+    }
+    putchar('"');
+}
+
+static void print_header(void) {
+    switch (opts.format) {
+    case FMT_TEXT:
+        printf("==================================================\n");
+        printf("  zlib Benchmark Harness\n");
+        printf("  zlib version: %s\n", zlibVersion());
+        printf("  Runtime: %s, backend: %s\n", opts.runtime, opts.backend);
+        printf("  %d reps + %d warmup, >= %.0f ms per rep\n",
+               opts.reps, opts.warmup, opts.min_time_ms);
+        printf("==================================================\n\n");
+        printf("  %-10s %-7s %8s %12s %10s %10s %12s\n",
+               "case", "pattern", "size", "MB/s", "stddev", "ci95", "ns/op");
+        break;
+    case FMT_CSV:
+        printf("runtime,backend,case,pattern,size,reps,iters,mean_mbps,stddev_mbps,ci95_mbps,ns_per_op\n");
+        break;
+    case FMT_JSON:
+        printf("{\n  \"runtime\": ");
+        print_json_string(opts.runtime);
+        printf(",\n  \"backend\": ");
+        print_json_string(opts.backend);
+        printf(",\n  \"zlib_version\": ");
+        print_json_string(zlibVersion());
+        printf(",\n");
+        printf("  \"reps\": %d,\n  \"warmup\": %d,\n  \"min_time_ms\": %.1f,\n",
+               opts.reps, opts.warmup, opts.min_time_ms);
+        printf("  \"results\": [");
+        break;
+    }
+}
+
+static void print_result(const char *name, const char *pattern, size_t size, const Stats *st) {
+    switch (opts.format) {
+    case FMT_TEXT:
+        printf("  %-10s %-7s %8zu %12.1f %10.1f %10.1f %12.1f\n",
+               name, pattern, size, st->mean, st->stddev, st->ci95, st->ns_per_op);
+        break;
+    case FMT_CSV:
+        printf("%s,%s,%s,%s,%zu,%d,%ld,%.3f,%.3f,%.3f,%.1f\n",
+               opts.runtime, opts.backend, name, pattern, size, opts.reps, st->iters,
+               st->mean, st->stddev, st->ci95, st->ns_per_op);
+        break;
+    case FMT_JSON:
+        printf("%s\n    {\"case\": ", first_result ? "" : ",");
+        print_json_string(name);
+        printf(", \"pattern\": ");
+        print_json_string(pattern);
+        printf(", \"size\": %zu, \"iters\": %ld, \"mean_mbps\": %.3f, "
+               "\"stddev_mbps\": %.3f, \"ci95_mbps\": %.3f, \"ns_per_op\": %.1f}",
+               size, st->iters, st->mean, st->stddev, st->ci95, st->ns_per_op);
+        break;
+    }
+    first_result = 0;
+    fflush(stdout);
+}
+
+static void print_footer(int failures) {
+    switch (opts.format) {
+    case FMT_TEXT:
+        printf("\n==================================================\n");
+        printf("  Benchmark complete, %d case(s) failed\n", failures);
+        printf("==================================================\n");
+        break;
+    case FMT_CSV:
+        break;
+    case FMT_JSON:
+        printf("\n  ],\n  \"failures\": %d\n}\n", failures);
+        break;
+    }
+}
+
+static int parse_args(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *val = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if (!val) {
+            fprintf(stderr, "Missing value for %s\n", arg);
+            return 0;
+        }
+        if (strcmp(arg, "--format") == 0) {
+            if (strcmp(val, "text") == 0) {
+                opts.format = FMT_TEXT;
+            } else if (strcmp(val, "csv") == 0) {
+                opts.format = FMT_CSV;
+            } else if (strcmp(val, "json") == 0) {
+                opts.format = FMT_JSON;
+            } else {
+                fprintf(stderr, "Unknown format: %s\n", val);
+                return 0;
+            }
+        } else if (strcmp(arg, "--reps") == 0) {
+            opts.reps = atoi(val);
+        } else if (strcmp(arg, "--warmup") == 0) {
+            opts.warmup = atoi(val);
+        } else if (strcmp(arg, "--min-time") == 0) {
+            opts.min_time_ms = atof(val);
+        } else if (strcmp(arg, "--filter") == 0) {
+            opts.filter = val;
+        } else if (strcmp(arg, "--runtime") == 0) {
+            opts.runtime = val;
+        } else if (strcmp(arg, "--backend") == 0) {
+            opts.backend = val;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", arg);
+            return 0;
+        }
+        i++;
+    }
+    if (opts.reps < 1 || opts.reps > MAX_REPS || opts.warmup < 0 || opts.min_time_ms <= 0) {
+        fprintf(stderr, "Invalid --reps, --warmup or --min-time\n");
+        return 0;
+    }
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
+    unsigned char *src = malloc(sizes[sizeof(sizes) / sizeof(sizes[0]) - 1]);
+    int failures = 0;
+
+    if (!parse_args(argc, argv)) {
+        return 2;
+    }
+    if (!opts.runtime) {
+#ifdef __wasm__
+        opts.runtime = "wasm";
+#else
+        opts.runtime = "native";
+#endif
+    }
+    if (!opts.backend) {
+        /* zlib-ng in compat mode reports e.g. "1.3.0.zlib-ng" */
+        opts.backend = strstr(zlibVersion(), "zlib-ng") ? "zlib-ng" : "zlib";
+    }
+    if (!src) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return 1;
+    }
+
+    print_header();
+
+    for (size_t p = 0; p < sizeof(patterns) / sizeof(patterns[0]); p++) {
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            Ctx ctx;
+
+            patterns[p].fill(src, sizes[s]);
+            if (!setup(&ctx, src, sizes[s])) {
+                fprintf(stderr, "Setup failed: %s/%zu\n", patterns[p].name, sizes[s]);
+                teardown(&ctx);
+                failures++;
+                continue;
+            }
+            for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+                Stats st;
+
+                if (opts.filter && !strstr(cases[c].name, opts.filter)) {
+                    continue;
+                }
+                if (!measure(&cases[c], &ctx, &st)) {
+                    fprintf(stderr, "Case failed: %s/%s/%zu\n",
+                            cases[c].name, patterns[p].name, sizes[s]);
+                    failures++;
+                    continue;
+                }
+                print_result(cases[c].name, patterns[p].name, sizes[s], &st);
+            }
+            teardown(&ctx);
+        }
+    }
+
+    print_footer(failures);
+    free(src);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+"""
+Tabulate bench_zlib results, or compare two runs and flag regressions.
+
+Each side is a bench_zlib JSON or CSV file, or a directory of them (as
+written by run_perf_test.sh). Results are matched on runtime, backend,
+case, pattern and size. A result regresses when its mean throughput
+drops by more than the threshold AND the 95% confidence intervals of the
+two runs do not overlap, so noisy cases are reported but do not fail.
+
+With a single argument, prints mean MB/s with one column per runtime
+(native, interp, aot, fast-jit, ...) and the ratio of each to native.
+
+Usage:
+    compare_bench.py RESULTS
+    compare_bench.py BASELINE CURRENT [--threshold PCT] [--all] [--allow-missing]
+
+Exit status is 1 if any case regressed or a baseline case is missing from
+the current run (a crashed or filtered run must not pass silently; use
+--allow-missing when comparing a deliberate subset), 0 otherwise.
+"""
+
+import argparse
+import csv
+import json
+import os
+import sys
+
+
+def load_file(path):
+    """Returns {(runtime, backend, case, pattern, size): result}"""
+    results = {}
+    if path.endswith(".csv"):
+        with open(path, newline="") as f:
+            for row in csv.DictReader(f):
+                key = (row["runtime"], row["backend"], row["case"],
+                       row["pattern"], int(row["size"]))
+                results[key] = {
+                    "mean": float(row["mean_mbps"]),
+                    "ci95": float(row["ci95_mbps"]),
+                }
+    else:
+        with open(path) as f:
+            run = json.load(f)
+        for r in run["results"]:
+            key = (run["runtime"], run["backend"], r["case"],
+                   r["pattern"], int(r["size"]))
+            results[key] = {"mean": r["mean_mbps"], "ci95": r["ci95_mbps"]}
+    return results
+
+
+def load(path):
+    if not os.path.isdir(path):
+        return load_file(path)
+    results = {}
+    for name in sorted(os.listdir(path)):
+        if name.endswith((".json", ".csv")):
+            results.update(load_file(os.path.join(path, name)))
+    return results
+
+
+def table(results):
+    runtimes = sorted({k[0] for k in results}, key=lambda r: (r != "native", r))
+    rows = sorted({k[1:] for k in results})
+
+    print(f"{'backend':<10} {'case':<10} {'pattern':<7} {'size':>8} " +
+          " ".join(f"{r:>10}" for r in runtimes) +
+          ("  " + " ".join(f"{r + '/nat':>12}" for r in runtimes if r != "native")
+           if "native" in runtimes else ""))
+    for row in rows:
+        means = [results.get((r,) + row, {}).get("mean") for r in runtimes]
+        line = f"{row[0]:<10} {row[1]:<10} {row[2]:<7} {row[3]:>8} " + \
+            " ".join(f"{m:>10.1f}" if m is not None else f"{'-':>10}" for m in means)
+        if "native" in runtimes:
+            native = means[0]
+            line += "  " + " ".join(
+                f"{100.0 * m / native:>11.0f}%" if m is not None and native else f"{'-':>12}"
+                for r, m in zip(runtimes, means) if r != "native")
+        print(line)
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare two bench_zlib runs")
+    parser.add_argument("baseline", help="baseline JSON/CSV file or directory")
+    parser.add_argument("current", nargs="?",
+                        help="current JSON/CSV file or directory (omit to tabulate)")
+    parser.add_argument("--threshold", type=float, default=5.0,
+                        help="regression threshold in percent (default: 5)")
+    parser.add_argument("--all", action="store_true",
+                        help="print every case, not only changed ones")
+    parser.add_argument("--allow-missing", action="store_true",
+                        help="do not fail on baseline cases missing from the current run")
+    args = parser.parse_args()
+
+    if args.current is None:
+        return table(load(args.baseline))
+
+    base = load(args.baseline)
+    cur = load(args.current)
+    regressions = 0
+
+    print(f"{'runtime':<8} {'backend':<10} {'case':<10} {'pattern':<7} {'size':>8} "
+          f"{'base MB/s':>11} {'cur MB/s':>11} {'delta':>8}  status")
+
+    for key in sorted(base.keys() & cur.keys()):
+        b, c = base[key], cur[key]
+        delta = 100.0 * (c["mean"] - b["mean"]) / b["mean"] if b["mean"] else 0.0
+        overlap = c["mean"] + c["ci95"] >= b["mean"] - b["ci95"] and \
+            b["mean"] + b["ci95"] >= c["mean"] - c["ci95"]
+
+        if delta < -args.threshold and not overlap:
+            status = "REGRESSION"
+            regressions += 1
+        elif delta < -args.threshold:
+            status = "slower (noise)"
+        elif delta > args.threshold and not overlap:
+            status = "faster"
+        else:
+            status = "ok"
+
+        if args.all or status != "ok":
+            runtime, backend, case, pattern, size = key
+            print(f"{runtime:<8} {backend:<10} {case:<10} {pattern:<7} {size:>8} "
+                  f"{b['mean']:>11.1f} {c['mean']:>11.1f} {delta:>7.1f}%  {status}")
+
+    missing = sorted(base.keys() - cur.keys())
+    for key in missing:
+        print(f"missing from current run: {' '.join(map(str, key))}")
+
+    print(f"\n{len(base.keys() & cur.keys())} cases compared, {regressions} regression(s), "
+          f"{len(missing)} missing{' (allowed)' if missing and args.allow_missing else ''} "
+          f"(threshold {args.threshold:.1f}%)")
+    return 1 if regressions or (missing and not args.allow_missing) else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,8 +1,15 @@
 #!/bin/bash
-# Compile test_zlib.c to WASM using WALI toolchain
+# Compile a zlib test program to WASM using WALI toolchain
+#
+# Usage: ./compile.sh [program]    (default: test_zlib)
+#
+# EXTRA_CFLAGS is appended to the compile flags, e.g.
+# EXTRA_CFLAGS=-DWALI_ZLIB_EXTENSIONS to use the WALI extension imports.
 
 set -e
 
+PROG=${1:-test_zlib}
+
 WALI_ROOT_DIR=/WALI
 WALI_BUILD_DIR=$WALI_ROOT_DIR/build
 WALI_LLVM_DIR=$WALI_BUILD_DIR/llvm
@@ -13,7 +20,7 @@ CC=$WALI_LLVM_BIN_DIR/clang
 LD=$WALI_LLVM_BIN_DIR/wasm-ld
 
 # Use the wali_shims zlib header
-ZLIB_SHIM_DIR=$WALI_ROOT_DIR/cpython/wali_shims
+ZLIB_SHIM_DIR=$WALI_ROOT_DIR/wali_shims
 
 CFLAGS="--target=wasm32-unknown-linux-muslwali \
     --sysroot=${WALI_SYSROOT_DIR} \
@@ -23,7 +30,8 @@ CFLAGS="--target=wasm32-unknown-linux-muslwali \
     -Wno-implicit-function-declaration \
     -mcpu=generic \
     -matomics \
-    -mbulk-memory"
+    -mbulk-memory \
+    ${EXTRA_CFLAGS}"
 
 LDFLAGS="-L${WALI_SYSROOT_DIR}/lib \
     -Wl,--shared-memory \
@@ -31,16 +39,16 @@ LDFLAGS="-L${WALI_SYSROOT_DIR}/lib \
     -Wl,--max-memory=2147483648 \
     -Wl,--allow-undefined"
 
-echo "Compiling test_zlib.c..."
-$CC $CFLAGS -c test_zlib.c -o test_zlib.o
+echo "Compiling ${PROG}.c..."
+$CC $CFLAGS -c ${PROG}.c -o ${PROG}.o
 
-echo "Linking test_zlib.wasm..."
-$CC $CFLAGS $LDFLAGS test_zlib.o -o test_zlib.wasm
+echo "Linking ${PROG}.wasm..."
+$CC $CFLAGS $LDFLAGS ${PROG}.o -o ${PROG}.wasm
 
-echo "Done! Created test_zlib.wasm"
-ls -la test_zlib.wasm
+echo "Done! Created ${PROG}.wasm"
+ls -la ${PROG}.wasm
 
 echo ""
 echo "Checking imports..."
-wasm-objdump -x test_zlib.wasm 2>/dev/null | grep -E "Import\[" | head -20 || \
-    $WALI_LLVM_BIN_DIR/llvm-nm test_zlib.wasm 2>/dev/null | grep " U " | head -20
+wasm-objdump -x ${PROG}.wasm 2>/dev/null | grep -E "Import\[" | head -20 || \
+    $WALI_LLVM_BIN_DIR/llvm-nm ${PROG}.wasm 2>/dev/null | grep " U " | head -20
@@ -0,0 +1,158 @@
+/**
+ * zlib Checksum Crossover Test
+ *
+ * Sweeps buffer lengths and times the two crc32/adler32 paths of the
+ * WALI shim separately: the in-guest table code used below
+ * WALI_ZLIB_INLINE_CKSUM_MAX, and the host import used above it. The
+ * first length at which the host wins is the right value for
+ * WALI_ZLIB_INLINE_CKSUM_MAX on that machine and engine.
+ *
+ * Native builds only have one path, so they print the library column.
+ *
+ * Compile native:
+ *   gcc -O2 -o perf_checksum_native perf_checksum.c -lz
+ *
+ * Compile WASM:
+ *   ./compile.sh perf_checksum
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <zlib.h>
+
+#define CALLS 1000000
+#define MAX_LEN 4096
+
+static const unsigned lengths[] = {
+    1, 4, 8, 16, 24, 32, 48, 64, 96, 128, 192, 256, 512, 1024, 2048, 4096
+};
+
+static double get_time_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Calls scaled down for long buffers so each row takes similar time */
+static int calls_for(unsigned len) {
+    return len <= 64 ? CALLS : (int)(CALLS * 64ull / len);
+}
+
+typedef uLong (*cksum_fn)(uLong, const Bytef *, uInt);
+
+#ifdef __wasm__
+static uLong inline_crc32(uLong crc, const Bytef *buf, uInt len) {
+    return wali_crc32_small(crc, buf, len);
+}
+
+static uLong inline_adler32(uLong adler, const Bytef *buf, uInt len) {
+    return wali_adler32_small(adler, buf, len);
+}
+
+static double time_path(cksum_fn fn, uLong init, const Bytef *buf, unsigned len, uLong *result) {
+    int calls = calls_for(len);
+    volatile uLong sink = init;
+    double start = get_time_ns();
+
+    for (int i = 0; i < calls; i++) {
+        sink = fn(sink, buf, len);
+    }
+    *result = fn(init, buf, len);
+    return (get_time_ns() - start) / calls;
+}
+
+static void sweep(const char *name, cksum_fn inline_fn, cksum_fn host_fn,
+                  uLong init, const Bytef *buf) {
+    unsigned crossover = 0;
+
+    printf("  %-8s %6s  %12s  %12s  %8s\n", name, "len", "inline ns", "host ns", "faster");
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        unsigned len = lengths[i];
+        uLong r_inline, r_host;
+        double t_inline = time_path(inline_fn, init, buf, len, &r_inline);
+        double t_host = time_path(host_fn, init, buf, len, &r_host);
+
+        if (r_inline != r_host) {
+            printf("  %-8s %6u  mismatch: inline=0x%08lx host=0x%08lx\n",
+                   name, len, r_inline, r_host);
+            continue;
+        }
+        if (!crossover && t_host < t_inline) {
+            crossover = len;
+        }
+        printf("  %-8s %6u  %12.1f  %12.1f  %8s\n", name, len, t_inline, t_host,
+               t_host < t_inline ? "host" : "inline");
+    }
+    if (crossover) {
+        printf("  %-8s crossover at %u bytes (WALI_ZLIB_INLINE_CKSUM_MAX=%d)\n",
+               name, crossover, WALI_ZLIB_INLINE_CKSUM_MAX);
+    } else {
+        printf("  %-8s inline faster at every length\n", name);
+    }
+}
+#else
+static void sweep(const char *name, cksum_fn fn, uLong init, const Bytef *buf) {
+    printf("  %-8s %6s  %12s\n", name, "len", "library ns");
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        unsigned len = lengths[i];
+        int calls = calls_for(len);
+        volatile uLong sink = init;
+        double start = get_time_ns();
+
+        for (int c = 0; c < calls; c++) {
+            sink = fn(sink, buf, len);
+        }
+        printf("  %-8s %6u  %12.1f\n", name, len, (get_time_ns() - start) / calls);
+    }
+}
+#endif
+
+int main(void) {
+    unsigned char *buf = malloc(MAX_LEN);
+
+    if (!buf) {
+        printf("Memory allocation failed\n");
+        return 1;
+    }
+    for (size_t i = 0; i < MAX_LEN; i++) {
+        buf[i] = (unsigned char)((i * 1103515245 + 12345) >> 16);
+    }
+
+    printf("==================================================\n");
+    printf("  zlib Checksum Crossover Test\n");
+    printf("  zlib version: %s\n", zlibVersion());
+#ifdef __wasm__
+    printf("  Platform: WebAssembly (WALI)\n");
+#else
+    printf("  Platform: Native\n");
+#endif
+    printf("==================================================\n\n");
+
+#ifdef __wasm__
+    printf("Test 1: crc32 inline vs host\n");
+    sweep("crc32", inline_crc32, wali_crc32_host, 0, buf);
+    printf("\n");
+
+    printf("Test 2: adler32 inline vs host\n");
+    sweep("adler32", inline_adler32, wali_adler32_host, 1, buf);
+    printf("\n");
+#else
+    printf("Test 1: crc32 library\n");
+    sweep("crc32", crc32, 0, buf);
+    printf("\n");
+
+    printf("Test 2: adler32 library\n");
+    sweep("adler32", adler32, 1, buf);
+    printf("\n");
+#endif
+
+    printf("==================================================\n");
+    printf("  Checksum crossover test complete!\n");
+    printf("==================================================\n");
+
+    free(buf);
+    return 0;
+}
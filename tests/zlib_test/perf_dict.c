@@ -0,0 +1,218 @@
+/**
+ * zlib Preset Dictionary Performance Test
+ *
+ * Compresses many small, similar messages (200 bytes of JSON) with a
+ * 32 KB preset dictionary, the way a message bus or RPC layer would.
+ * Compares attaching the dictionary per stream with
+ * deflateSetDictionary/inflateSetDictionary against registering it once
+ * with zdict_register and attaching it by ID.
+ *
+ * Compile native:
+ *   gcc -O2 -o perf_dict_native perf_dict.c -lz
+ *
+ * Compile WASM:
+ *   ./compile.sh perf_dict
+ *   EXTRA_CFLAGS=-DWALI_ZLIB_EXTENSIONS ./compile.sh perf_dict
+ *     (dictionary IDs; needs a runtime that has the WALI zlib extensions)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <zlib.h>
+
+#define MESSAGES 20000
+#define MSG_SIZE 200
+#define DICT_SIZE 32768
+
+#if !defined(__wasm__) || !defined(WALI_ZLIB_EXTENSIONS)
+/* Native zlib and the shipped WALI runtime have no dictionary registry:
+ * keep the buffer and fall back to the per-stream calls, so both columns
+ * measure the same work */
+typedef uint32_t z_dict_id;
+
+static const Bytef *native_dict;
+static uInt native_dict_len;
+
+static z_dict_id zdict_register(const Bytef *dictionary, uInt dictLength) {
+    native_dict = dictionary;
+    native_dict_len = dictLength;
+    return 1;
+}
+
+static int zdict_release(z_dict_id id) {
+    (void)id;
+    native_dict = NULL;
+    return Z_OK;
+}
+
+static int deflateSetDictionaryId(z_streamp strm, z_dict_id id) {
+    (void)id;
+    return deflateSetDictionary(strm, native_dict, native_dict_len);
+}
+
+static int inflateSetDictionaryId(z_streamp strm, z_dict_id id) {
+    (void)id;
+    return inflateSetDictionary(strm, native_dict, native_dict_len);
+}
+#endif
+
+static double get_time_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/* Message n: a JSON event padded to MSG_SIZE, similar to its neighbours */
+static void make_message(char *msg, int n) {
+    int len = snprintf(msg, MSG_SIZE,
+        "{\"id\":%d,\"type\":\"%s\",\"user\":\"user-%04d\",\"region\":\"eu-west-%d\","
+        "\"status\":\"%s\",\"latency_ms\":%d,\"tags\":[\"wali\",\"zlib\"]}",
+        n, n % 3 ? "page_view" : "checkout", n % 9973, n % 4,
+        n % 5 ? "ok" : "error", 10 + n % 490);
+    memset(msg + len, ' ', MSG_SIZE - len);
+}
+
+/* Dictionary: earlier messages back to back, newest (most useful) last */
+static void make_dictionary(unsigned char *dict) {
+    char msg[MSG_SIZE];
+    for (int off = 0, n = 0; off < DICT_SIZE; off += MSG_SIZE, n++) {
+        int len = DICT_SIZE - off < MSG_SIZE ? DICT_SIZE - off : MSG_SIZE;
+        make_message(msg, 1000000 + n);
+        memcpy(dict + off, msg, len);
+    }
+}
+
+typedef struct {
+    double deflate_ms;
+    double inflate_ms;
+    size_t compressed_bytes;
+    int ok;
+} Result;
+
+static Result run(const unsigned char *dict, z_dict_id id, int use_id) {
+    Result r = { 0, 0, 0, 0 };
+    char msg[MSG_SIZE];
+    unsigned char out[MSG_SIZE * 2];
+    unsigned char back[MSG_SIZE];
+    z_stream def, inf;
+    double start;
+    int ret;
+
+    memset(&def, 0, sizeof(def));
+    memset(&inf, 0, sizeof(inf));
+    if (deflateInit(&def, Z_DEFAULT_COMPRESSION) != Z_OK || inflateInit(&inf) != Z_OK) {
+        return r;
+    }
+
+    for (int n = 0; n < MESSAGES; n++) {
+        make_message(msg, n);
+
+        start = get_time_ms();
+        deflateReset(&def);
+        ret = use_id ? deflateSetDictionaryId(&def, id)
+                     : deflateSetDictionary(&def, dict, DICT_SIZE);
+        if (ret != Z_OK) {
+            goto done;
+        }
+        def.next_in = (Bytef *)msg;
+        def.avail_in = MSG_SIZE;
+        def.next_out = out;
+        def.avail_out = sizeof(out);
+        if (deflate(&def, Z_FINISH) != Z_STREAM_END) {
+            goto done;
+        }
+        r.deflate_ms += get_time_ms() - start;
+        r.compressed_bytes += def.total_out;
+
+        start = get_time_ms();
+        inflateReset(&inf);
+        inf.next_in = out;
+        inf.avail_in = def.total_out;
+        inf.next_out = back;
+        inf.avail_out = sizeof(back);
+        ret = inflate(&inf, Z_FINISH);
+        if (ret == Z_NEED_DICT) {
+            ret = use_id ? inflateSetDictionaryId(&inf, id)
+                         : inflateSetDictionary(&inf, dict, DICT_SIZE);
+            if (ret != Z_OK) {
+                goto done;
+            }
+            ret = inflate(&inf, Z_FINISH);
+        }
+        r.inflate_ms += get_time_ms() - start;
+        if (ret != Z_STREAM_END || memcmp(msg, back, MSG_SIZE) != 0) {
+            goto done;
+        }
+    }
+    r.ok = 1;
+
+done:
+    deflateEnd(&def);
+    inflateEnd(&inf);
+    return r;
+}
+
+static void print_result(const char *label, Result r) {
+    if (!r.ok) {
+        printf("  [%s] round trip failed\n", label);
+        return;
+    }
+    printf("  [%s] deflate=%.2f ms (%.2f us/msg), inflate=%.2f ms (%.2f us/msg), avg %.1f bytes/msg\n",
+           label, r.deflate_ms, r.deflate_ms * 1000.0 / MESSAGES,
+           r.inflate_ms, r.inflate_ms * 1000.0 / MESSAGES,
+           (double)r.compressed_bytes / MESSAGES);
+}
+
+int main(void) {
+    unsigned char *dict = malloc(DICT_SIZE);
+    Result by_buffer, by_id;
+    z_dict_id id;
+    double start, register_ms;
+
+    if (!dict) {
+        printf("Memory allocation failed\n");
+        return 1;
+    }
+    make_dictionary(dict);
+
+    printf("==================================================\n");
+    printf("  zlib Preset Dictionary Performance Test\n");
+    printf("  zlib version: %s\n", zlibVersion());
+#ifdef __wasm__
+    printf("  Platform: WebAssembly (WALI)\n");
+#else
+    printf("  Platform: Native\n");
+#endif
+    printf("  %d messages x %d bytes, %d KB dictionary\n", MESSAGES, MSG_SIZE, DICT_SIZE / 1024);
+    printf("==================================================\n\n");
+
+    printf("Test 1: per-stream dictionary vs registered dictionary ID\n");
+
+    by_buffer = run(dict, 0, 0);
+    print_result("buffer", by_buffer);
+
+    start = get_time_ms();
+    id = zdict_register(dict, DICT_SIZE);
+    register_ms = get_time_ms() - start;
+    if (id == 0) {
+        printf("  [id] zdict_register failed\n");
+    } else {
+        by_id = run(dict, id, 1);
+        print_result("id", by_id);
+        printf("  register=%.3f ms, deflate speedup=%.2fx, inflate speedup=%.2fx\n",
+               register_ms, by_buffer.deflate_ms / by_id.deflate_ms,
+               by_buffer.inflate_ms / by_id.inflate_ms);
+        zdict_release(id);
+    }
+    printf("\n");
+
+    printf("==================================================\n");
+    printf("  Dictionary test complete!\n");
+    printf("==================================================\n");
+
+    free(dict);
+    return 0;
+}
@@ -0,0 +1,350 @@
+/**
+ * zlib Stream Fork Performance Test
+ *
+ * Primes a 15-bit-window deflate stream with a shared header, then forks
+ * it once per message with deflateCopy, the way a protocol encoder reuses
+ * a common preamble. The same is done on the inflate side with
+ * inflateCopy. Without copy-on-write every fork duplicates the full
+ * window and hash tables (~256 KB for deflate), most of which the fork
+ * never writes. On a runtime with copy-on-write support (not in this
+ * tree), run the WASM build with WALI_ZLIB_COW_COPY=1 to compare.
+ *
+ * Tests:
+ * 1. deflate: re-prime per message vs deflateCopy of a primed stream
+ * 2. inflate: inflateCopy of a primed stream
+ * 3. memory held by live forks (WALI arena counters, extensions only)
+ *
+ * Compile native:
+ *   gcc -O2 -o perf_fork_native perf_fork.c -lz
+ *
+ * Compile WASM:
+ *   ./compile.sh perf_fork
+ *   EXTRA_CFLAGS=-DWALI_ZLIB_EXTENSIONS ./compile.sh perf_fork
+ *     (arena counters; needs a runtime that has the WALI zlib extensions)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <zlib.h>
+
+/* The WALI extension imports (wali_shims/zlib.h) are opt-in: without them
+ * the WASM build only calls what the shipped runtime provides */
+#if defined(__wasm__) && defined(WALI_ZLIB_EXTENSIONS)
+#define HAVE_WALI_ZEXT 1
+#endif
+
+#define FORKS 10000
+#define LIVE_FORKS 256
+#define HEADER_SIZE 16384
+#define MSG_SIZE 512
+#define WINDOW_BITS 15
+#define OUT_CAP (HEADER_SIZE + MSG_SIZE)
+
+static double get_time_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void generate_header(unsigned char *buf, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        buf[i] = (unsigned char)((i * 7 + i / 13) % 95 + 32);
+    }
+}
+
+static void make_message(unsigned char *msg, int n) {
+    int len = snprintf((char *)msg, MSG_SIZE, "message %d: payload follows the shared header. ", n);
+    for (int i = len; i < MSG_SIZE; i++) {
+        msg[i] = (unsigned char)('a' + (i * n) % 26);
+    }
+}
+
+static int deflate_init(z_stream *strm) {
+    memset(strm, 0, sizeof(*strm));
+    return deflateInit2(strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, WINDOW_BITS,
+                        8, Z_DEFAULT_STRATEGY);
+}
+
+/* Feed data and flush; returns bytes written to out, or -1 */
+static long deflate_chunk(z_stream *strm, const unsigned char *in, size_t len,
+                          unsigned char *out, size_t cap, int flush) {
+    strm->next_in = (Bytef *)in;
+    strm->avail_in = len;
+    strm->next_out = out;
+    strm->avail_out = cap;
+    if (deflate(strm, flush) == Z_STREAM_ERROR || strm->avail_in != 0) {
+        return -1;
+    }
+    return (long)(cap - strm->avail_out);
+}
+
+/* Inflate prefix + tail and compare with header + message */
+static int verify(const unsigned char *prefix, long prefix_len,
+                  const unsigned char *tail, long tail_len,
+                  const unsigned char *header, const unsigned char *msg) {
+    unsigned char out[OUT_CAP];
+    z_stream strm;
+    int ok;
+
+    memset(&strm, 0, sizeof(strm));
+    if (inflateInit2(&strm, WINDOW_BITS) != Z_OK) {
+        return 0;
+    }
+    strm.next_out = out;
+    strm.avail_out = sizeof(out);
+    strm.next_in = (Bytef *)prefix;
+    strm.avail_in = prefix_len;
+    inflate(&strm, Z_NO_FLUSH);
+    strm.next_in = (Bytef *)tail;
+    strm.avail_in = tail_len;
+    ok = inflate(&strm, Z_FINISH) == Z_STREAM_END &&
+         strm.total_out == OUT_CAP &&
+         memcmp(out, header, HEADER_SIZE) == 0 &&
+         memcmp(out + HEADER_SIZE, msg, MSG_SIZE) == 0;
+    inflateEnd(&strm);
+    return ok;
+}
+
+#ifdef HAVE_WALI_ZEXT
+static void print_mem_stats(const char *label, int forks) {
+    wali_zstats stats;
+
+    if (zlibStats(&stats, 0) != Z_OK) {
+        return;
+    }
+    printf("  [%s] %d live forks: %.1f MB held, %.0f bytes/fork\n", label, forks,
+           stats.mem_live / 1048576.0, (double)stats.mem_live / (forks + 1));
+}
+#endif
+
+/* Test 1: deflate fork cost */
+static void test_deflate_fork(const unsigned char *header, unsigned char *prefix, long *prefix_len) {
+    unsigned char msg[MSG_SIZE];
+    unsigned char *out = malloc(OUT_CAP);
+    z_stream primed, fork;
+    double start, replay_ns, copy_ns = 0, fork_ns;
+    long n;
+    int errors = 0;
+
+    *prefix_len = -1;
+    if (!out || deflate_init(&primed) != Z_OK) {
+        printf("  [deflate] setup failed\n");
+        free(out);
+        return;
+    }
+    /* Sync flush leaves the prefix byte-aligned, so every fork appends to it */
+    *prefix_len = deflate_chunk(&primed, header, HEADER_SIZE, prefix, OUT_CAP, Z_SYNC_FLUSH);
+    if (*prefix_len < 0) {
+        printf("  [deflate] priming failed\n");
+        goto cleanup;
+    }
+
+    /* Replay: what a caller without deflateCopy does for every message */
+    start = get_time_ns();
+    for (int i = 0; i < FORKS; i++) {
+        make_message(msg, i);
+        if (deflate_init(&fork) != Z_OK) {
+            errors++;
+            continue;
+        }
+        if (deflate_chunk(&fork, header, HEADER_SIZE, out, OUT_CAP, Z_SYNC_FLUSH) < 0 ||
+            deflate_chunk(&fork, msg, MSG_SIZE, out, OUT_CAP, Z_FINISH) < 0) {
+            errors++;
+        }
+        deflateEnd(&fork);
+    }
+    replay_ns = (get_time_ns() - start) / FORKS;
+
+    /* Fork: copy the primed stream and only deflate the message */
+    start = get_time_ns();
+    for (int i = 0; i < FORKS; i++) {
+        double t = get_time_ns();
+
+        make_message(msg, i);
+        if (deflateCopy(&fork, &primed) != Z_OK) {
+            errors++;
+            continue;
+        }
+        copy_ns += get_time_ns() - t;
+        n = deflate_chunk(&fork, msg, MSG_SIZE, out, OUT_CAP, Z_FINISH);
+        if (n < 0 || (i % 1000 == 0 && !verify(prefix, *prefix_len, out, n, header, msg))) {
+            errors++;
+        }
+        deflateEnd(&fork);
+    }
+    fork_ns = (get_time_ns() - start) / FORKS;
+    copy_ns /= FORKS;
+
+    printf("  [deflate] replay=%.2f us/msg, fork=%.2f us/msg (deflateCopy %.2f us), %.1fx\n",
+           replay_ns / 1000.0, fork_ns / 1000.0, copy_ns / 1000.0, replay_ns / fork_ns);
+    if (errors) {
+        printf("  [deflate] %d forks failed or produced wrong data!\n", errors);
+    }
+
+cleanup:
+    deflateEnd(&primed);
+    free(out);
+}
+
+/* Test 2: inflate fork cost, primed on the shared compressed prefix */
+static void test_inflate_fork(const unsigned char *header, const unsigned char *prefix, long prefix_len) {
+    unsigned char msg[MSG_SIZE];
+    unsigned char out[MSG_SIZE];
+    unsigned char *scratch = malloc(HEADER_SIZE);
+    unsigned char tail[MSG_SIZE * 2];
+    z_stream primed, fork, def;
+    double start, copy_ns = 0, fork_ns;
+    long tail_len;
+    int errors = 0;
+
+    memset(&primed, 0, sizeof(primed));
+    if (!scratch || prefix_len < 0 || inflateInit2(&primed, WINDOW_BITS) != Z_OK) {
+        printf("  [inflate] setup failed\n");
+        free(scratch);
+        return;
+    }
+    primed.next_in = (Bytef *)prefix;
+    primed.avail_in = prefix_len;
+    primed.next_out = scratch;
+    primed.avail_out = HEADER_SIZE;
+    if (inflate(&primed, Z_SYNC_FLUSH) != Z_OK || memcmp(scratch, header, HEADER_SIZE) != 0) {
+        printf("  [inflate] priming failed\n");
+        goto cleanup;
+    }
+
+    /* One compressed tail, produced by a fork of the matching deflate stream */
+    make_message(msg, 0);
+    if (deflate_init(&def) != Z_OK) {
+        goto cleanup;
+    }
+    deflate_chunk(&def, header, HEADER_SIZE, scratch, HEADER_SIZE, Z_SYNC_FLUSH);
+    tail_len = deflate_chunk(&def, msg, MSG_SIZE, tail, sizeof(tail), Z_FINISH);
+    deflateEnd(&def);
+    if (tail_len < 0) {
+        printf("  [inflate] deflate of tail failed\n");
+        goto cleanup;
+    }
+
+    start = get_time_ns();
+    for (int i = 0; i < FORKS; i++) {
+        double t = get_time_ns();
+
+        if (inflateCopy(&fork, &primed) != Z_OK) {
+            errors++;
+            continue;
+        }
+        copy_ns += get_time_ns() - t;
+        fork.next_in = tail;
+        fork.avail_in = tail_len;
+        fork.next_out = out;
+        fork.avail_out = sizeof(out);
+        if (inflate(&fork, Z_FINISH) != Z_STREAM_END || memcmp(out, msg, MSG_SIZE) != 0) {
+            errors++;
+        }
+        inflateEnd(&fork);
+    }
+    fork_ns = (get_time_ns() - start) / FORKS;
+    copy_ns /= FORKS;
+
+    printf("  [inflate] fork=%.2f us/msg (inflateCopy %.2f us)\n",
+           fork_ns / 1000.0, copy_ns / 1000.0);
+    if (errors) {
+        printf("  [inflate] %d forks failed or produced wrong data!\n", errors);
+    }
+
+cleanup:
+    inflateEnd(&primed);
+    free(scratch);
+}
+
+/* Test 3: hold LIVE_FORKS copies at once; with COW they share pages */
+static void test_live_forks(const unsigned char *header) {
+    z_stream *forks = calloc(LIVE_FORKS, sizeof(z_stream));
+    unsigned char msg[MSG_SIZE];
+    unsigned char *out = malloc(OUT_CAP);
+    z_stream primed;
+    double start, elapsed;
+    int live = 0;
+
+    if (!forks || !out || deflate_init(&primed) != Z_OK) {
+        printf("  [live] setup failed\n");
+        free(forks);
+        free(out);
+        return;
+    }
+    deflate_chunk(&primed, header, HEADER_SIZE, out, OUT_CAP, Z_SYNC_FLUSH);
+
+    start = get_time_ns();
+    while (live < LIVE_FORKS && deflateCopy(&forks[live], &primed) == Z_OK) {
+        live++;
+    }
+    elapsed = get_time_ns() - start;
+    printf("  [live] %d forks in %.2f ms\n", live, elapsed / 1e6);
+#ifdef HAVE_WALI_ZEXT
+    print_mem_stats("live", live);
+#endif
+
+    /* Each fork now writes, touching (and with COW, copying) its pages */
+    for (int i = 0; i < live; i++) {
+        make_message(msg, i);
+        deflate_chunk(&forks[i], msg, MSG_SIZE, out, OUT_CAP, Z_FINISH);
+    }
+#ifdef HAVE_WALI_ZEXT
+    print_mem_stats("written", live);
+#endif
+
+    for (int i = 0; i < live; i++) {
+        deflateEnd(&forks[i]);
+    }
+    deflateEnd(&primed);
+    free(forks);
+    free(out);
+}
+
+int main(void) {
+    unsigned char *header = malloc(HEADER_SIZE);
+    unsigned char *prefix = malloc(OUT_CAP);
+    long prefix_len = -1;
+
+    if (!header || !prefix) {
+        printf("Memory allocation failed\n");
+        return 1;
+    }
+    generate_header(header, HEADER_SIZE);
+
+    printf("==================================================\n");
+    printf("  zlib Stream Fork Performance Test\n");
+    printf("  zlib version: %s\n", zlibVersion());
+#ifdef __wasm__
+    printf("  Platform: WebAssembly (WALI)\n");
+    printf("  Copy-on-write: %s\n", getenv("WALI_ZLIB_COW_COPY") ? "requested (needs runtime support)" : "off");
+#else
+    printf("  Platform: Native\n");
+#endif
+    printf("  %d KB header, %d byte messages, windowBits %d\n",
+           HEADER_SIZE / 1024, MSG_SIZE, WINDOW_BITS);
+    printf("==================================================\n\n");
+
+    printf("Test 1: deflate fork (%d messages)\n", FORKS);
+    test_deflate_fork(header, prefix, &prefix_len);
+    printf("\n");
+
+    printf("Test 2: inflate fork (%d messages)\n", FORKS);
+    test_inflate_fork(header, prefix, prefix_len);
+    printf("\n");
+
+    printf("Test 3: live forks\n");
+    test_live_forks(header);
+    printf("\n");
+
+    printf("==================================================\n");
+    printf("  Fork test complete!\n");
+    printf("==================================================\n");
+
+    free(header);
+    free(prefix);
+    return 0;
+}
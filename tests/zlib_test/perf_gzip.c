@@ -0,0 +1,428 @@
+/**
+ * Gzip File I/O Performance Test
+ *
+ * Benchmarks the gzFile bridge on test_gzip.c-style files (repeated text
+ * lines), large enough that per-call overhead is not what is measured.
+ *
+ * Tests:
+ * 1. random seeks on a read stream, with and without a gzindex
+ * 2. sequential write/read, synchronous vs async ('A' mode) files; 'A'
+ *    needs runtime support not in this tree, elsewhere both are synchronous
+ * 3. full-file scan throughput by read size (mmap read path where the
+ *    runtime has it; not in this tree)
+ * 4. full-file scan, single member vs many concatenated members (members
+ *    are only inflated ahead in parallel by runtimes that support it)
+ *
+ * Usage: perf_gzip [size_mb]    (default: 64 MB of uncompressed data)
+ *
+ * Compile native:
+ *   gcc -O2 -o perf_gzip_native perf_gzip.c -lz
+ *
+ * Compile WASM:
+ *   ./compile.sh perf_gzip
+ *   EXTRA_CFLAGS=-DWALI_ZLIB_EXTENSIONS ./compile.sh perf_gzip
+ *     (gzindex; needs a runtime that has the WALI zlib extensions)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <zlib.h>
+
+#define TEST_FILE "perf_gzip.gz"
+#define INDEX_FILE "perf_gzip.gzi"
+#define DEFAULT_SIZE_MB 64
+#define LINE_SIZE 64
+#define READ_SIZE 4096
+#define SEEKS 200
+#define INDEX_SPAN (1024 * 1024)
+#define ASYNC_FILE "perf_gzip_async.gz"
+#define MULTI_FILE "perf_gzip_multi.gz"
+#define MEMBERS 32
+
+#if !defined(__wasm__) || !defined(WALI_ZLIB_EXTENSIONS)
+/* Native zlib and the shipped WALI runtime have no index support: report
+ * it and fall back to plain seeks */
+static int gzindex(gzFile file, z_off_t span, const char *index_path) {
+    (void)file; (void)span; (void)index_path;
+    return Z_STREAM_ERROR;
+}
+#endif
+
+static double get_time_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/* Same generator as test_gzip.c: numbered text lines of fixed width */
+static void fill_line(char *line, long n) {
+    snprintf(line, LINE_SIZE, "Line %010u: %-46s", (unsigned)n, "Hello, WALI gzip! Testing gzip file I/O.");
+    line[LINE_SIZE - 1] = '\n';
+}
+
+static int write_test_file(const char *path, long size) {
+    char line[LINE_SIZE];
+    gzFile f = gzopen(path, "wb6");
+
+    if (!f) {
+        return 0;
+    }
+    for (long off = 0; off < size; off += LINE_SIZE) {
+        fill_line(line, off / LINE_SIZE);
+        if (gzwrite(f, line, LINE_SIZE) != LINE_SIZE) {
+            gzclose(f);
+            return 0;
+        }
+    }
+    return gzclose(f) == Z_OK;
+}
+
+/* Same content as write_test_file, cut into members appended one by one */
+static int write_multi_member(const char *path, long size, int members) {
+    char line[LINE_SIZE];
+    long lines = size / LINE_SIZE;
+    long per_member = (lines + members - 1) / members;
+
+    for (long first = 0; first < lines; first += per_member) {
+        gzFile f = gzopen(path, first == 0 ? "wb6" : "ab6");
+
+        if (!f) {
+            return 0;
+        }
+        for (long n = first; n < first + per_member && n < lines; n++) {
+            fill_line(line, n);
+            if (gzwrite(f, line, LINE_SIZE) != LINE_SIZE) {
+                gzclose(f);
+                return 0;
+            }
+        }
+        if (gzclose(f) != Z_OK) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Small LCG so every run visits the same offsets */
+static uint32_t rng_state = 12345;
+
+static uint32_t next_rand(void) {
+    rng_state = rng_state * 1103515245u + 12345u;
+    return rng_state >> 8;
+}
+
+/* Seek to SEEKS random line-aligned offsets and verify a read at each */
+static double run_seeks(gzFile f, long size, int *errors) {
+    char buf[READ_SIZE];
+    char expect[LINE_SIZE];
+    double start = get_time_ms();
+    long lines = (size - READ_SIZE) / LINE_SIZE;
+
+    rng_state = 12345;
+    for (int i = 0; i < SEEKS; i++) {
+        long line_no = (long)(((uint64_t)next_rand() << 8 | (next_rand() & 0xff)) % lines);
+        z_off_t off = (z_off_t)line_no * LINE_SIZE;
+
+        if (gzseek(f, off, SEEK_SET) != off ||
+            gzread(f, buf, READ_SIZE) != READ_SIZE) {
+            (*errors)++;
+            continue;
+        }
+        fill_line(expect, line_no);
+        if (memcmp(buf, expect, LINE_SIZE) != 0) {
+            (*errors)++;
+        }
+    }
+    return get_time_ms() - start;
+}
+
+/* Test 1: random seeks, plain gzseek vs gzindex access points */
+static void test_random_seek(long size) {
+    double plain_time, build_time, indexed_time, sidecar_time;
+    int errors = 0;
+    gzFile f;
+
+    remove(INDEX_FILE);
+
+    /* Plain: every backward seek re-inflates from the start of the file */
+    f = gzopen(TEST_FILE, "rb");
+    if (!f) {
+        printf("  gzopen for read failed\n");
+        return;
+    }
+    plain_time = run_seeks(f, size, &errors);
+    gzclose(f);
+
+    /* Indexed: one sequential pass records access points */
+    f = gzopen(TEST_FILE, "rb");
+    if (!f) {
+        printf("  gzopen for read failed\n");
+        return;
+    }
+    if (gzindex(f, INDEX_SPAN, INDEX_FILE) != Z_OK) {
+        printf("  plain:   %d seeks in %.2f ms (%.2f ms/seek)\n",
+               SEEKS, plain_time, plain_time / SEEKS);
+        printf("  gzindex unavailable (needs WALI_ZLIB_EXTENSIONS and runtime support)\n");
+        gzclose(f);
+        return;
+    }
+    build_time = get_time_ms();
+    gzseek(f, size - 1, SEEK_SET);
+    gzrewind(f);
+    build_time = get_time_ms() - build_time;
+    indexed_time = run_seeks(f, size, &errors);
+    gzclose(f);
+
+    /* Sidecar: a fresh open loads the persisted index, no build pass */
+    f = gzopen(TEST_FILE, "rb");
+    if (!f) {
+        printf("  gzopen for read failed\n");
+        return;
+    }
+    sidecar_time = get_time_ms();
+    gzindex(f, INDEX_SPAN, INDEX_FILE);
+    sidecar_time = get_time_ms() - sidecar_time;
+    sidecar_time += run_seeks(f, size, &errors);
+    gzclose(f);
+
+    printf("  plain:   %d seeks in %.2f ms (%.2f ms/seek)\n",
+           SEEKS, plain_time, plain_time / SEEKS);
+    printf("  indexed: %d seeks in %.2f ms (%.3f ms/seek), build pass %.2f ms\n",
+           SEEKS, indexed_time, indexed_time / SEEKS, build_time);
+    printf("  sidecar: %d seeks in %.2f ms incl. index load\n", SEEKS, sidecar_time);
+    printf("  speedup: %.1fx (indexed vs plain)\n", plain_time / indexed_time);
+    if (errors) {
+        printf("  %d seeks returned wrong data!\n", errors);
+    }
+
+    remove(INDEX_FILE);
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return x < y ? -1 : x > y;
+}
+
+/* Stand-in for the caller's own work on each chunk (log parsing) */
+static long count_lines(const char *buf, int len) {
+    long n = 0;
+    for (int i = 0; i < len; i++) {
+        n += buf[i] == '\n';
+    }
+    return n;
+}
+
+static void print_latency(const char *label, double total_ms, long size,
+                          double *lat_us, int calls) {
+    qsort(lat_us, calls, sizeof(double), cmp_double);
+    printf("  %-10s %8.1f MB/s   p50=%7.2f us  p99=%7.2f us  max=%8.2f us\n",
+           label, (size / 1024.0 / 1024.0) / (total_ms / 1000.0),
+           lat_us[calls / 2], lat_us[(int)(calls * 0.99)], lat_us[calls - 1]);
+}
+
+/* One pass: gzwrite (or gzread) READ_SIZE chunks, timing every call */
+static int run_stream(const char *mode, long size, double *lat_us, double *total_ms) {
+    char buf[READ_SIZE];
+    int writing = mode[0] == 'w';
+    int calls = (int)(size / READ_SIZE);
+    long lines = 0;
+    double start, t;
+    gzFile f;
+
+    if (writing) {
+        for (int i = 0; i < READ_SIZE / LINE_SIZE; i++) {
+            fill_line(buf + i * LINE_SIZE, i);
+        }
+    }
+
+    start = get_time_ms();
+    f = gzopen(ASYNC_FILE, mode);
+    if (!f) {
+        return 0;
+    }
+    for (int i = 0; i < calls; i++) {
+        t = get_time_ms();
+        if ((writing ? gzwrite(f, buf, READ_SIZE) : gzread(f, buf, READ_SIZE)) != READ_SIZE) {
+            gzclose(f);
+            return 0;
+        }
+        lat_us[i] = (get_time_ms() - t) * 1000.0;
+        lines += count_lines(buf, READ_SIZE);
+    }
+    /* The close drains the async writer, so it belongs in the total */
+    if (gzclose(f) != Z_OK) {
+        return 0;
+    }
+    *total_ms = get_time_ms() - start;
+    return lines == (long)calls * (READ_SIZE / LINE_SIZE);
+}
+
+/* Test 2: sequential throughput and per-call latency, sync vs async */
+static void test_async_stream(long size) {
+    static const char *modes[][2] = {
+        { "wb6",  "write" }, { "wb6A", "write+A" },
+        { "rb",   "read" },  { "rbA",  "read+A" },
+    };
+    int calls = (int)(size / READ_SIZE);
+    double *lat_us = malloc(calls * sizeof(double));
+    double total_ms;
+
+    if (!lat_us) {
+        printf("  Memory allocation failed\n");
+        return;
+    }
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        if (!run_stream(modes[m][0], size, lat_us, &total_ms)) {
+            printf("  %-10s failed\n", modes[m][1]);
+            continue;
+        }
+        print_latency(modes[m][1], total_ms, size, lat_us, calls);
+    }
+    free(lat_us);
+    remove(ASYNC_FILE);
+}
+
+/* Test 3: read the whole file with one buffer size, report MB/s */
+static void test_scan(long size) {
+    static const unsigned sizes[] = { 4096, 65536, 1048576 };
+    char *buf = malloc(sizes[sizeof(sizes) / sizeof(sizes[0]) - 1]);
+
+    if (!buf) {
+        printf("  Memory allocation failed\n");
+        return;
+    }
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        long total = 0;
+        z_off_t compressed;
+        double elapsed = get_time_ms();
+        gzFile f = gzopen(TEST_FILE, "rb");
+        int n;
+
+        if (!f) {
+            printf("  gzopen for read failed\n");
+            break;
+        }
+        while ((n = gzread(f, buf, sizes[s])) > 0) {
+            total += n;
+        }
+        compressed = gzoffset(f);
+        gzclose(f);
+        elapsed = get_time_ms() - elapsed;
+
+        if (n < 0 || total != size) {
+            printf("  [%7u] scan failed: read %ld of %ld bytes\n", sizes[s], total, size);
+            continue;
+        }
+        printf("  [%7u] %.2f ms, %.1f MB/s uncompressed, %.1f MB/s compressed\n",
+               sizes[s], elapsed, (size / 1024.0 / 1024.0) / (elapsed / 1000.0),
+               (compressed / 1024.0 / 1024.0) / (elapsed / 1000.0));
+    }
+    free(buf);
+}
+
+/* Scan a file with 1 MB reads, checking the first line of every read */
+static double scan_file(const char *path, long size) {
+    const unsigned read_size = 1048576;
+    char *buf = malloc(read_size);
+    char expect[LINE_SIZE];
+    long total = 0;
+    double elapsed = get_time_ms();
+    gzFile f = gzopen(path, "rb");
+    int n = -1;
+
+    if (buf && f) {
+        while ((n = gzread(f, buf, read_size)) > 0) {
+            fill_line(expect, total / LINE_SIZE);
+            if (memcmp(buf, expect, LINE_SIZE) != 0) {
+                n = -1;
+                break;
+            }
+            total += n;
+        }
+    }
+    if (f) {
+        gzclose(f);
+    }
+    free(buf);
+    elapsed = get_time_ms() - elapsed;
+    return n < 0 || total != size ? -1.0 : elapsed;
+}
+
+/* Test 4: the same data as one member and as MEMBERS concatenated ones */
+static void test_multi_member_scan(long size) {
+    double single_time, multi_time;
+
+    if (!write_multi_member(MULTI_FILE, size, MEMBERS)) {
+        printf("  Failed to write %s\n", MULTI_FILE);
+        return;
+    }
+    single_time = scan_file(TEST_FILE, size);
+    multi_time = scan_file(MULTI_FILE, size);
+    remove(MULTI_FILE);
+
+    if (single_time < 0 || multi_time < 0) {
+        printf("  scan failed or returned wrong data\n");
+        return;
+    }
+    printf("  [1 member]   %.2f ms, %.1f MB/s\n",
+           single_time, (size / 1024.0 / 1024.0) / (single_time / 1000.0));
+    printf("  [%d members] %.2f ms, %.1f MB/s\n", MEMBERS,
+           multi_time, (size / 1024.0 / 1024.0) / (multi_time / 1000.0));
+    printf("  speedup: %.2fx (multi vs single)\n", single_time / multi_time);
+}
+
+int main(int argc, char *argv[]) {
+    long size_mb = argc > 1 ? atol(argv[1]) : DEFAULT_SIZE_MB;
+    long size = size_mb * 1024 * 1024;
+    double elapsed;
+
+    if (size_mb <= 0) {
+        printf("Invalid size: %s\n", argv[1]);
+        return 1;
+    }
+
+    printf("==================================================\n");
+    printf("  Gzip File I/O Performance Test\n");
+    printf("  zlib version: %s\n", zlibVersion());
+#ifdef __wasm__
+    printf("  Platform: WebAssembly (WALI)\n");
+#else
+    printf("  Platform: Native\n");
+#endif
+    printf("  File: %ld MB uncompressed\n", size_mb);
+    printf("==================================================\n\n");
+
+    elapsed = get_time_ms();
+    if (!write_test_file(TEST_FILE, size)) {
+        printf("Failed to write %s\n", TEST_FILE);
+        return 1;
+    }
+    elapsed = get_time_ms() - elapsed;
+    printf("Wrote %s in %.2f ms\n\n", TEST_FILE, elapsed);
+
+    printf("Test 1: Random seeks (%d x %d byte reads)\n", SEEKS, READ_SIZE);
+    test_random_seek(size);
+    printf("\n");
+
+    printf("Test 2: Sequential stream, sync vs async (%d byte calls)\n", READ_SIZE);
+    test_async_stream(size);
+    printf("\n");
+
+    printf("Test 3: Full scan by read size\n");
+    test_scan(size);
+    printf("\n");
+
+    printf("Test 4: Multi-member scan (%d members)\n", MEMBERS);
+    test_multi_member_scan(size);
+    printf("\n");
+
+    printf("==================================================\n");
+    printf("  Gzip performance test complete!\n");
+    printf("==================================================\n");
+
+    remove(TEST_FILE);
+    return 0;
+}
@@ -0,0 +1,211 @@
+/**
+ * zlib inflateBack Performance Test
+ *
+ * Compares inflate() against inflateBack() on 1 MB raw deflate inputs.
+ * inflateBack decodes straight out of its window and hands every chunk to
+ * the out() callback, so it avoids inflate's output-buffer copies. The
+ * callback counts below are what a WALI runtime would pay a host -> WASM
+ * call for. Running the inflateBack rows under WASM requires runtime
+ * support (not in this tree) for calling the guest's in()/out() callbacks.
+ *
+ * Compile native:
+ *   gcc -O2 -o perf_inflateback_native perf_inflateback.c -lz
+ *
+ * Compile WASM:
+ *   ./compile.sh perf_inflateback
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <zlib.h>
+
+#define ITERATIONS 100
+#define DATA_SIZE 1048576        /* 1 MB */
+#define WINDOW_BITS 15
+#define IN_CHUNK 16384           /* bytes handed out per in() call */
+
+/* Source and sink passed to the callbacks through in_desc/out_desc */
+typedef struct {
+    unsigned char *buf;
+    size_t len;
+    size_t pos;
+    long calls;
+} Cursor;
+
+static double get_time_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static void generate_data(unsigned char *buf, size_t size, int pattern) {
+    uint32_t state = 12345;
+    for (size_t i = 0; i < size; i++) {
+        state = state * 1103515245u + 12345u;
+        buf[i] = pattern ? (unsigned char)(state >> 16)
+                         : (unsigned char)((i * 7 + i / 13) % 95 + 32);
+    }
+}
+
+static unsigned in_cb(void *desc, unsigned char **buf) {
+    Cursor *c = desc;
+    size_t n = c->len - c->pos;
+
+    if (n > IN_CHUNK) {
+        n = IN_CHUNK;
+    }
+    *buf = c->buf + c->pos;
+    c->pos += n;
+    c->calls++;
+    return (unsigned)n;
+}
+
+static int out_cb(void *desc, unsigned char *buf, unsigned len) {
+    Cursor *c = desc;
+
+    c->calls++;
+    if (len > c->len - c->pos) {
+        return 1;
+    }
+    memcpy(c->buf + c->pos, buf, len);
+    c->pos += len;
+    return 0;
+}
+
+/* Raw deflate (no zlib header), as required by inflateBack */
+static size_t raw_deflate(unsigned char *dst, size_t cap, unsigned char *src, size_t len) {
+    z_stream strm;
+    size_t out_len = 0;
+
+    memset(&strm, 0, sizeof(strm));
+    if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -WINDOW_BITS,
+                     8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return 0;
+    }
+    strm.next_in = src;
+    strm.avail_in = len;
+    strm.next_out = dst;
+    strm.avail_out = cap;
+    if (deflate(&strm, Z_FINISH) == Z_STREAM_END) {
+        out_len = strm.total_out;
+    }
+    deflateEnd(&strm);
+    return out_len;
+}
+
+static void test_inflate_vs_back(int pattern, const char *label) {
+    unsigned char *original = malloc(DATA_SIZE);
+    unsigned char *compressed = malloc(DATA_SIZE * 2);
+    unsigned char *decompressed = malloc(DATA_SIZE);
+    unsigned char *window = malloc(1 << WINDOW_BITS);
+    double inflate_time, back_time;
+    long in_calls = 0, out_calls = 0;
+    size_t compressed_len;
+    z_stream strm;
+    int ret;
+
+    if (!original || !compressed || !decompressed || !window) {
+        printf("  [%s] Memory allocation failed\n", label);
+        goto cleanup;
+    }
+
+    generate_data(original, DATA_SIZE, pattern);
+    compressed_len = raw_deflate(compressed, DATA_SIZE * 2, original, DATA_SIZE);
+    if (compressed_len == 0) {
+        printf("  [%s] deflate failed\n", label);
+        goto cleanup;
+    }
+
+    /* inflate: whole input, whole output buffer */
+    inflate_time = get_time_ms();
+    for (int i = 0; i < ITERATIONS; i++) {
+        memset(&strm, 0, sizeof(strm));
+        inflateInit2(&strm, -WINDOW_BITS);
+        strm.next_in = compressed;
+        strm.avail_in = compressed_len;
+        strm.next_out = decompressed;
+        strm.avail_out = DATA_SIZE;
+        ret = inflate(&strm, Z_FINISH);
+        inflateEnd(&strm);
+        if (ret != Z_STREAM_END) {
+            printf("  [%s] inflate failed: %d\n", label, ret);
+            goto cleanup;
+        }
+    }
+    inflate_time = get_time_ms() - inflate_time;
+
+    if (memcmp(original, decompressed, DATA_SIZE) != 0) {
+        printf("  [%s] inflate data mismatch!\n", label);
+        goto cleanup;
+    }
+    memset(decompressed, 0, DATA_SIZE);
+
+    /* inflateBack: input pulled and output pushed through callbacks */
+    back_time = get_time_ms();
+    for (int i = 0; i < ITERATIONS; i++) {
+        Cursor in = { compressed, compressed_len, 0, 0 };
+        Cursor out = { decompressed, DATA_SIZE, 0, 0 };
+
+        memset(&strm, 0, sizeof(strm));
+        ret = inflateBackInit(&strm, WINDOW_BITS, window);
+        if (ret != Z_OK) {
+            printf("  [%s] inflateBackInit failed: %d\n", label, ret);
+            goto cleanup;
+        }
+        ret = inflateBack(&strm, in_cb, &in, out_cb, &out);
+        inflateBackEnd(&strm);
+        if (ret != Z_STREAM_END) {
+            printf("  [%s] inflateBack failed: %d\n", label, ret);
+            goto cleanup;
+        }
+        in_calls += in.calls;
+        out_calls += out.calls;
+    }
+    back_time = get_time_ms() - back_time;
+
+    if (memcmp(original, decompressed, DATA_SIZE) != 0) {
+        printf("  [%s] inflateBack data mismatch!\n", label);
+        goto cleanup;
+    }
+
+    printf("  [%s] ratio=%.1f%%, inflate=%.2f ms (%.1f MB/s), inflateBack=%.2f ms (%.1f MB/s), %.2fx\n",
+           label, 100.0 * compressed_len / DATA_SIZE,
+           inflate_time, (DATA_SIZE * ITERATIONS / 1024.0 / 1024.0) / (inflate_time / 1000.0),
+           back_time, (DATA_SIZE * ITERATIONS / 1024.0 / 1024.0) / (back_time / 1000.0),
+           inflate_time / back_time);
+    printf("  [%s] callbacks per stream: in=%ld, out=%ld\n",
+           label, in_calls / ITERATIONS, out_calls / ITERATIONS);
+
+cleanup:
+    free(original);
+    free(compressed);
+    free(decompressed);
+    free(window);
+}
+
+int main(void) {
+    printf("==================================================\n");
+    printf("  zlib inflateBack Performance Test\n");
+    printf("  zlib version: %s\n", zlibVersion());
+#ifdef __wasm__
+    printf("  Platform: WebAssembly (WALI)\n");
+#else
+    printf("  Platform: Native\n");
+#endif
+    printf("  Data: %d KB x %d iterations\n", DATA_SIZE / 1024, ITERATIONS);
+    printf("==================================================\n\n");
+
+    printf("Test 1: inflate vs inflateBack\n");
+    test_inflate_vs_back(0, "text");
+    test_inflate_vs_back(1, "binary");
+    printf("\n");
+
+    printf("==================================================\n");
+    printf("  inflateBack test complete!\n");
+    printf("==================================================\n");
+
+    return 0;
+}
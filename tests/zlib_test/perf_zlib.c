@@ -3,17 +3,25 @@
  * 
  * This test compares zlib compression/decompression performance.
  * Can be compiled and run both natively and as WASM via iwasm.
+ * Kept for the WALI-specific paths (stats, batching, parallel levels);
+ * cross-runtime numbers with confidence intervals come from bench_zlib.c.
  * 
  * Tests:
  * 1. compress/uncompress API (buffer-based)
  * 2. deflate/inflate API (streaming)
  * 3. crc32/adler32 checksums
+ * 4. compression levels
+ * 5. small-chunk streaming (4 KB socket-sized reads)
+ * 6. batched compress/uncompress/crc32 (one host call per batch)
+ * 7. parallel compress2 (Z_WALI_PARALLEL, WALI_ZLIB_EXTENSIONS builds only)
  * 
  * Compile native:
  *   gcc -O2 -o perf_zlib_native perf_zlib.c -lz
  * 
  * Compile WASM:
  *   ./compile.sh perf_zlib
+ *   EXTRA_CFLAGS=-DWALI_ZLIB_EXTENSIONS ./compile.sh perf_zlib
+ *     (bridge counters and extension imports; needs a runtime that has them)
  */
 
 #include <stdio.h>
@@ -28,6 +36,18 @@
 #define SMALL_SIZE 1024          /* 1 KB */
 #define MEDIUM_SIZE 65536        /* 64 KB */
 #define LARGE_SIZE 1048576       /* 1 MB */
+#define CHUNK_SIZE 4096          /* 4 KB, a typical socket read */
+#define BATCH_ITEMS 10000
+
+/* The WALI extension imports (wali_shims/zlib.h) are opt-in: without them
+ * the WASM build only calls what the shipped runtime provides */
+#if defined(__wasm__) && defined(WALI_ZLIB_EXTENSIONS)
+#define HAVE_WALI_ZEXT 1
+#endif
+
+/* Test 7 level: the parallel flag needs an explicit level, not
+ * Z_DEFAULT_COMPRESSION (-1), which absorbs it */
+#define PARALLEL_LEVEL 6
 
 /* Timer utilities */
 typedef struct {
@@ -69,6 +89,38 @@ static void generate_test_data(unsigned char *buf, size_t size, int pattern) {
     }
 }
 
+#ifdef HAVE_WALI_ZEXT
+/* Per-call z_stream sync cost as counted by the WALI bridge */
+static void print_sync_stats(const char *label, long calls) {
+    wali_zstats stats;
+    
+    if (zlibStats(&stats, 1) != Z_OK || calls == 0) {
+        return;
+    }
+    printf("    %s sync: %.1f fields/call, %.1f ns/call, %llu/%llu reverse syncs skipped\n",
+           label, (double)stats.sync_fields / calls, (double)stats.sync_ns / calls,
+           (unsigned long long)stats.sync_skipped, (unsigned long long)stats.sync_calls);
+}
+
+/* Native stream state reuse across Init/End cycles; silent when the
+ * runtime has no stream pool and leaves both counters at 0 */
+static void print_pool_stats(const char *label) {
+    wali_zstats stats;
+    uint64_t lookups;
+    
+    if (zlibStats(&stats, 1) != Z_OK) {
+        return;
+    }
+    lookups = stats.pool_hits + stats.pool_misses;
+    if (lookups == 0) {
+        return;
+    }
+    printf("    %s pool: %llu/%llu hits (%.1f%%)\n", label,
+           (unsigned long long)stats.pool_hits, (unsigned long long)lookups,
+           100.0 * stats.pool_hits / lookups);
+}
+#endif
+
 /* Test 1: compress/uncompress buffer API */
 static void test_compress_buffer(size_t data_size, int iterations, const char *label) {
     unsigned char *original = malloc(data_size);
@@ -156,6 +208,9 @@ static void test_deflate_stream(size_t data_size, int iterations, const char *la
     size_t compressed_len = 0;
     
     /* Benchmark deflate */
+#ifdef HAVE_WALI_ZEXT
+    zlibStats(NULL, 1);
+#endif
     timer_start(&timer);
     for (int i = 0; i < iterations; i++) {
         memset(&strm, 0, sizeof(strm));
@@ -181,6 +236,9 @@ static void test_deflate_stream(size_t data_size, int iterations, const char *la
         deflateEnd(&strm);
     }
     deflate_time = timer_elapsed_ms(&timer);
+#ifdef HAVE_WALI_ZEXT
+    print_pool_stats("deflate");
+#endif
     
     /* Benchmark inflate */
     timer_start(&timer);
@@ -207,6 +265,9 @@ static void test_deflate_stream(size_t data_size, int iterations, const char *la
         inflateEnd(&strm);
     }
     inflate_time = timer_elapsed_ms(&timer);
+#ifdef HAVE_WALI_ZEXT
+    print_pool_stats("inflate");
+#endif
     
     /* Verify correctness */
     if (memcmp(original, decompressed, data_size) != 0) {
@@ -268,6 +329,331 @@ static void test_checksums(size_t data_size, int iterations, const char *label)
     free(data);
 }
 
+/* Test 5: stream data through deflate/inflate in small fixed-size chunks */
+static void test_chunked_stream(size_t data_size, int iterations, const char *label) {
+    unsigned char *original = malloc(data_size);
+    unsigned char *compressed = malloc(data_size * 2);
+    unsigned char *decompressed = malloc(data_size);
+    Timer timer;
+    double deflate_time = 0, inflate_time = 0;
+    long deflate_calls = 0, inflate_calls = 0;
+    size_t compressed_len = 0;
+    z_stream strm;
+    int ret = Z_OK;
+    
+    if (!original || !compressed || !decompressed) {
+        printf("  [%s] Memory allocation failed\n", label);
+        goto cleanup;
+    }
+    
+    generate_test_data(original, data_size, 1);
+    
+    /* Benchmark deflate: feed CHUNK_SIZE bytes per call */
+#ifdef HAVE_WALI_ZEXT
+    zlibStats(NULL, 1);
+#endif
+    timer_start(&timer);
+    for (int i = 0; i < iterations; i++) {
+        memset(&strm, 0, sizeof(strm));
+        ret = deflateInit(&strm, Z_DEFAULT_COMPRESSION);
+        if (ret != Z_OK) {
+            printf("  [%s] deflateInit failed: %d\n", label, ret);
+            goto cleanup;
+        }
+        strm.next_out = compressed;
+        strm.avail_out = data_size * 2;
+        
+        for (size_t off = 0; off < data_size; off += CHUNK_SIZE) {
+            size_t n = data_size - off < CHUNK_SIZE ? data_size - off : CHUNK_SIZE;
+            strm.next_in = original + off;
+            strm.avail_in = n;
+            ret = deflate(&strm, off + n == data_size ? Z_FINISH : Z_NO_FLUSH);
+            deflate_calls++;
+            if (ret != Z_OK) {
+                break;
+            }
+        }
+        
+        compressed_len = strm.total_out;
+        deflateEnd(&strm);
+        if (ret != Z_STREAM_END) {
+            printf("  [%s] chunked deflate failed: %d\n", label, ret);
+            goto cleanup;
+        }
+    }
+    deflate_time = timer_elapsed_ms(&timer);
+#ifdef HAVE_WALI_ZEXT
+    print_sync_stats("deflate", deflate_calls);
+#endif
+    
+    /* Benchmark inflate: compressed input arrives CHUNK_SIZE bytes at a time */
+    timer_start(&timer);
+    for (int i = 0; i < iterations; i++) {
+        memset(&strm, 0, sizeof(strm));
+        ret = inflateInit(&strm);
+        if (ret != Z_OK) {
+            printf("  [%s] inflateInit failed: %d\n", label, ret);
+            goto cleanup;
+        }
+        strm.next_out = decompressed;
+        strm.avail_out = data_size;
+        
+        for (size_t off = 0; off < compressed_len; off += CHUNK_SIZE) {
+            size_t n = compressed_len - off < CHUNK_SIZE ? compressed_len - off : CHUNK_SIZE;
+            strm.next_in = compressed + off;
+            strm.avail_in = n;
+            ret = inflate(&strm, Z_NO_FLUSH);
+            inflate_calls++;
+            if (ret != Z_OK) {
+                break;
+            }
+        }
+        
+        inflateEnd(&strm);
+        if (ret != Z_STREAM_END) {
+            printf("  [%s] chunked inflate failed: %d\n", label, ret);
+            goto cleanup;
+        }
+    }
+    inflate_time = timer_elapsed_ms(&timer);
+#ifdef HAVE_WALI_ZEXT
+    print_sync_stats("inflate", inflate_calls);
+#endif
+    
+    if (memcmp(original, decompressed, data_size) != 0) {
+        printf("  [%s] Data mismatch!\n", label);
+        goto cleanup;
+    }
+    
+    printf("  [%s] size=%zu, chunk=%d, deflate=%.2f ms (%.0f ns/call), inflate=%.2f ms (%.0f ns/call)\n",
+           label, data_size, CHUNK_SIZE,
+           deflate_time, deflate_time * 1e6 / deflate_calls,
+           inflate_time, inflate_time * 1e6 / inflate_calls);
+
+cleanup:
+    free(original);
+    free(compressed);
+    free(decompressed);
+}
+
+#ifndef HAVE_WALI_ZEXT
+/* Native zlib and the shipped WALI runtime have no batch entry points;
+ * a plain loop stands in, so both columns time the same work */
+typedef struct {
+    const Bytef *src;
+    uLong srcLen;
+    Bytef *dst;
+    uLong dstCap;
+    uLong dstLen;
+    int status;
+} z_batch;
+
+static int compress_batch(z_batch *items, uInt count, int level) {
+    int first = Z_OK;
+    for (uInt i = 0; i < count; i++) {
+        items[i].dstLen = items[i].dstCap;
+        items[i].status = compress2(items[i].dst, &items[i].dstLen,
+                                    items[i].src, items[i].srcLen, level);
+        if (first == Z_OK) first = items[i].status;
+    }
+    return first;
+}
+
+static int uncompress_batch(z_batch *items, uInt count) {
+    int first = Z_OK;
+    for (uInt i = 0; i < count; i++) {
+        items[i].dstLen = items[i].dstCap;
+        items[i].status = uncompress(items[i].dst, &items[i].dstLen,
+                                     items[i].src, items[i].srcLen);
+        if (first == Z_OK) first = items[i].status;
+    }
+    return first;
+}
+
+static int crc32_batch(uLong crc, z_batch *items, uInt count) {
+    for (uInt i = 0; i < count; i++) {
+        items[i].dstLen = crc32(crc, items[i].src, items[i].srcLen);
+        items[i].status = Z_OK;
+    }
+    return Z_OK;
+}
+#endif
+
+/* Test 6: many small one-shot calls, per-call loop vs a single batch call */
+static void test_batch(size_t item_size, int count, const char *label) {
+    size_t bound = compressBound(item_size);
+    unsigned char *original = malloc(item_size * count);
+    unsigned char *compressed = malloc(bound * count);
+    unsigned char *decompressed = malloc(item_size * count);
+    z_batch *items = malloc(sizeof(z_batch) * count);
+    Timer timer;
+    double loop_compress, loop_uncompress, loop_crc;
+    double batch_compress, batch_uncompress, batch_crc;
+    int ret;
+    
+    if (!original || !compressed || !decompressed || !items) {
+        printf("  [%s] Memory allocation failed\n", label);
+        goto cleanup;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        generate_test_data(original + i * item_size, item_size, i % 2);
+    }
+    
+    /* Loop: one host call per item */
+    timer_start(&timer);
+    for (int i = 0; i < count; i++) {
+        uLongf len = bound;
+        compress(compressed + i * bound, &len, original + i * item_size, item_size);
+        items[i].srcLen = len;
+    }
+    loop_compress = timer_elapsed_ms(&timer);
+    
+    timer_start(&timer);
+    for (int i = 0; i < count; i++) {
+        uLongf len = item_size;
+        uncompress(decompressed + i * item_size, &len, compressed + i * bound, items[i].srcLen);
+    }
+    loop_uncompress = timer_elapsed_ms(&timer);
+    
+    timer_start(&timer);
+    for (int i = 0; i < count; i++) {
+        items[i].dstLen = crc32(0L, original + i * item_size, item_size);
+    }
+    loop_crc = timer_elapsed_ms(&timer);
+    
+    /* Batch: one host call for all items */
+    for (int i = 0; i < count; i++) {
+        items[i].src = original + i * item_size;
+        items[i].srcLen = item_size;
+        items[i].dst = compressed + i * bound;
+        items[i].dstCap = bound;
+    }
+    timer_start(&timer);
+    ret = compress_batch(items, count, Z_DEFAULT_COMPRESSION);
+    batch_compress = timer_elapsed_ms(&timer);
+    if (ret != Z_OK) {
+        printf("  [%s] compress_batch failed: %d\n", label, ret);
+        goto cleanup;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        items[i].src = compressed + i * bound;
+        items[i].srcLen = items[i].dstLen;
+        items[i].dst = decompressed + i * item_size;
+        items[i].dstCap = item_size;
+    }
+    memset(decompressed, 0, item_size * count);
+    timer_start(&timer);
+    ret = uncompress_batch(items, count);
+    batch_uncompress = timer_elapsed_ms(&timer);
+    if (ret != Z_OK) {
+        printf("  [%s] uncompress_batch failed: %d\n", label, ret);
+        goto cleanup;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        items[i].src = original + i * item_size;
+        items[i].srcLen = item_size;
+    }
+    timer_start(&timer);
+    crc32_batch(0L, items, count);
+    batch_crc = timer_elapsed_ms(&timer);
+    
+    if (memcmp(original, decompressed, item_size * count) != 0 ||
+        items[count - 1].dstLen != crc32(0L, original + (count - 1) * item_size, item_size)) {
+        printf("  [%s] Data mismatch!\n", label);
+        goto cleanup;
+    }
+    
+    printf("  [%s] items=%d, compress loop=%.2f ms batch=%.2f ms (%.2fx)\n",
+           label, count, loop_compress, batch_compress, loop_compress / batch_compress);
+    printf("  [%s] items=%d, uncompress loop=%.2f ms batch=%.2f ms (%.2fx)\n",
+           label, count, loop_uncompress, batch_uncompress, loop_uncompress / batch_uncompress);
+    printf("  [%s] items=%d, crc32 loop=%.2f ms batch=%.2f ms (%.2fx)\n",
+           label, count, loop_crc, batch_crc, loop_crc / batch_crc);
+
+cleanup:
+    free(original);
+    free(compressed);
+    free(decompressed);
+    free(items);
+}
+
+/* Test 7: compress2 serial vs Z_WALI_PARALLEL on the same input, at the
+ * same explicit level */
+static void test_parallel_compress(size_t data_size, int iterations, const char *label) {
+    unsigned char *original = malloc(data_size);
+    unsigned char *compressed = malloc(compressBound(data_size));
+    unsigned char *decompressed = malloc(data_size);
+    Timer timer;
+    double serial_time;
+    uLongf serial_len = 0;
+    int ret;
+    
+    if (!original || !compressed || !decompressed) {
+        printf("  [%s] Memory allocation failed\n", label);
+        goto cleanup;
+    }
+    
+    generate_test_data(original, data_size, 1);
+    
+    timer_start(&timer);
+    for (int i = 0; i < iterations; i++) {
+        serial_len = compressBound(data_size);
+        ret = compress2(compressed, &serial_len, original, data_size, PARALLEL_LEVEL);
+        if (ret != Z_OK) {
+            printf("  [%s] compress2 failed: %d\n", label, ret);
+            goto cleanup;
+        }
+    }
+    serial_time = timer_elapsed_ms(&timer);
+    
+#ifndef HAVE_WALI_ZEXT
+    printf("  [%s] serial=%.2f ms (%.1f MB/s, %lu bytes), parallel: needs WALI_ZLIB_EXTENSIONS\n",
+           label, serial_time, (data_size * iterations / 1024.0 / 1024.0) / (serial_time / 1000.0),
+           serial_len);
+#else
+    double parallel_time;
+    uLongf parallel_len = 0, decompressed_len;
+    
+    timer_start(&timer);
+    for (int i = 0; i < iterations; i++) {
+        parallel_len = compressBound(data_size);
+        ret = compress2(compressed, &parallel_len, original, data_size,
+                        Z_WALI_PARALLEL_LEVEL(PARALLEL_LEVEL));
+        if (ret == Z_STREAM_ERROR) {
+            printf("  [%s] parallel mode unavailable in this runtime\n", label);
+            goto cleanup;
+        }
+        if (ret != Z_OK) {
+            printf("  [%s] parallel compress2 failed: %d\n", label, ret);
+            goto cleanup;
+        }
+    }
+    parallel_time = timer_elapsed_ms(&timer);
+    
+    /* The parallel output must still be a plain zlib stream */
+    decompressed_len = data_size;
+    ret = uncompress(decompressed, &decompressed_len, compressed, parallel_len);
+    if (ret != Z_OK || decompressed_len != data_size ||
+        memcmp(original, decompressed, data_size) != 0) {
+        printf("  [%s] Parallel output does not round-trip: %d\n", label, ret);
+        goto cleanup;
+    }
+    
+    printf("  [%s] serial=%.2f ms (%.1f MB/s, %lu bytes), parallel=%.2f ms (%.1f MB/s, %lu bytes), speedup=%.2fx\n",
+           label, serial_time, (data_size * iterations / 1024.0 / 1024.0) / (serial_time / 1000.0),
+           serial_len, parallel_time, (data_size * iterations / 1024.0 / 1024.0) / (parallel_time / 1000.0),
+           parallel_len, serial_time / parallel_time);
+#endif
+
+cleanup:
+    free(original);
+    free(compressed);
+    free(decompressed);
+}
+
 /* Test different compression levels */
 static void test_compression_levels(size_t data_size, int iterations) {
     unsigned char *original = malloc(data_size);
@@ -344,6 +730,23 @@ int main(int argc, char *argv[]) {
     test_compression_levels(MEDIUM_SIZE, ITERATIONS / 10);
     printf("\n");
     
+    /* Test 5: Small-chunk streaming */
+    printf("Test 5: Small-chunk streaming (%d byte chunks)\n", CHUNK_SIZE);
+    test_chunked_stream(MEDIUM_SIZE, ITERATIONS, "64KB");
+    test_chunked_stream(LARGE_SIZE, ITERATIONS / 10, "1MB");
+    printf("\n");
+    
+    /* Test 6: Batched one-shot calls */
+    printf("Test 6: Batched one-shot calls (loop vs batch)\n");
+    test_batch(SMALL_SIZE, BATCH_ITEMS, "1KB");
+    printf("\n");
+    
+    /* Test 7: Parallel deflate */
+    printf("Test 7: Parallel compress2 (Z_WALI_PARALLEL)\n");
+    test_parallel_compress(LARGE_SIZE, ITERATIONS / 10, "1MB");
+    test_parallel_compress(LARGE_SIZE * 16, ITERATIONS / 100, "16MB");
+    printf("\n");
+    
     printf("==================================================\n");
     printf("  Performance test complete!\n");
     printf("==================================================\n");
@@ -0,0 +1,207 @@
+/**
+ * zlib Multi-threaded Performance Test
+ *
+ * Threaded variant of perf_zlib.c. Each worker runs its own
+ * deflate/inflate streaming loop on private buffers, so the only shared
+ * state is inside the bridge (handle tables). Aggregate throughput should
+ * scale linearly with the thread count up to the number of host cores;
+ * a flat line points at a lock on the wali_deflate/wali_inflate hot path.
+ *
+ * Small messages are the interesting case: with 1 KB buffers the handle
+ * resolution is a large share of every call.
+ *
+ * Compile native:
+ *   gcc -O2 -pthread -o perf_zlib_mt_native perf_zlib_mt.c -lz
+ *
+ * Compile WASM:
+ *   ./compile.sh perf_zlib_mt
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <zlib.h>
+
+#define MAX_THREADS 64
+#define SMALL_SIZE 1024          /* 1 KB */
+#define MEDIUM_SIZE 65536        /* 64 KB */
+
+/* Total bytes per worker per run, so each row does the same work per thread */
+#define BYTES_PER_THREAD (64 * 1048576)
+
+typedef struct {
+    size_t data_size;
+    int iterations;
+    int failed;
+} Worker;
+
+static double get_time_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static void generate_data(unsigned char *buf, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        buf[i] = (unsigned char)((i * 7 + i / 13) % 95 + 32);
+    }
+}
+
+/* One deflate + inflate round trip per iteration, streams kept open */
+static void *worker_main(void *arg) {
+    Worker *w = arg;
+    size_t size = w->data_size;
+    unsigned char *original = malloc(size);
+    unsigned char *compressed = malloc(size * 2);
+    unsigned char *decompressed = malloc(size);
+    z_stream def, inf;
+    int ret = Z_OK;
+
+    w->failed = 1;
+    if (!original || !compressed || !decompressed) {
+        goto cleanup;
+    }
+    generate_data(original, size);
+
+    memset(&def, 0, sizeof(def));
+    memset(&inf, 0, sizeof(inf));
+    if (deflateInit(&def, Z_DEFAULT_COMPRESSION) != Z_OK) {
+        goto cleanup;
+    }
+    if (inflateInit(&inf) != Z_OK) {
+        deflateEnd(&def);
+        goto cleanup;
+    }
+
+    for (int i = 0; i < w->iterations; i++) {
+        deflateReset(&def);
+        def.next_in = original;
+        def.avail_in = size;
+        def.next_out = compressed;
+        def.avail_out = size * 2;
+        ret = deflate(&def, Z_FINISH);
+        if (ret != Z_STREAM_END) {
+            break;
+        }
+
+        inflateReset(&inf);
+        inf.next_in = compressed;
+        inf.avail_in = def.total_out;
+        inf.next_out = decompressed;
+        inf.avail_out = size;
+        ret = inflate(&inf, Z_FINISH);
+        if (ret != Z_STREAM_END) {
+            break;
+        }
+    }
+
+    if (ret == Z_STREAM_END && memcmp(original, decompressed, size) == 0) {
+        w->failed = 0;
+    }
+
+    deflateEnd(&def);
+    inflateEnd(&inf);
+
+cleanup:
+    free(original);
+    free(compressed);
+    free(decompressed);
+    return NULL;
+}
+
+/* Returns aggregate throughput in MB/s, or a negative value on failure */
+static double run_threads(int nthreads, size_t data_size) {
+    pthread_t threads[MAX_THREADS];
+    Worker workers[MAX_THREADS];
+    int iterations = BYTES_PER_THREAD / data_size;
+    double start, elapsed;
+    int failed = 0;
+
+    for (int t = 0; t < nthreads; t++) {
+        workers[t].data_size = data_size;
+        workers[t].iterations = iterations;
+        workers[t].failed = 0;
+    }
+
+    start = get_time_ms();
+    for (int t = 0; t < nthreads; t++) {
+        if (pthread_create(&threads[t], NULL, worker_main, &workers[t]) != 0) {
+            printf("  pthread_create failed for thread %d\n", t);
+            nthreads = t;
+            failed = 1;
+            break;
+        }
+    }
+    for (int t = 0; t < nthreads; t++) {
+        pthread_join(threads[t], NULL);
+        failed |= workers[t].failed;
+    }
+    elapsed = get_time_ms() - start;
+
+    if (failed) {
+        return -1.0;
+    }
+    return (2.0 * data_size * iterations * nthreads / 1024.0 / 1024.0) / (elapsed / 1000.0);
+}
+
+static void test_scaling(size_t data_size, int max_threads, const char *label) {
+    double base = 0;
+
+    printf("  [%s] %8s  %10s  %8s  %10s\n", label, "threads", "MB/s", "speedup", "efficiency");
+
+    /* Powers of 2, always finishing on the core count itself */
+    for (int n = 1; n <= max_threads;
+         n = (n < max_threads && n * 2 > max_threads) ? max_threads : n * 2) {
+        double mbps = run_threads(n, data_size);
+        if (mbps < 0) {
+            printf("  [%s] %8d  round trip failed\n", label, n);
+            return;
+        }
+        if (n == 1) {
+            base = mbps;
+        }
+        printf("  [%s] %8d  %10.1f  %7.2fx  %9.0f%%\n",
+               label, n, mbps, mbps / base, 100.0 * mbps / base / n);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    int max_threads = argc > 1 ? atoi(argv[1]) : (int)ncpu;
+
+    if (max_threads < 1) {
+        max_threads = 1;
+    }
+    if (max_threads > MAX_THREADS) {
+        max_threads = MAX_THREADS;
+    }
+
+    printf("==================================================\n");
+    printf("  zlib Multi-threaded Performance Test\n");
+    printf("  zlib version: %s\n", zlibVersion());
+#ifdef __wasm__
+    printf("  Platform: WebAssembly (WALI)\n");
+#else
+    printf("  Platform: Native\n");
+#endif
+    printf("  Host cores: %ld, max threads: %d\n", ncpu, max_threads);
+    printf("==================================================\n\n");
+
+    printf("Test 1: deflate/inflate round trip, small messages\n");
+    test_scaling(SMALL_SIZE, max_threads, "1KB");
+    printf("\n");
+
+    printf("Test 2: deflate/inflate round trip, medium messages\n");
+    test_scaling(MEDIUM_SIZE, max_threads, "64KB");
+    printf("\n");
+
+    printf("==================================================\n");
+    printf("  Multi-threaded test complete!\n");
+    printf("==================================================\n");
+
+    return 0;
+}
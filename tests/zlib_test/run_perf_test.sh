@@ -1,10 +1,35 @@
 #!/bin/bash
-# run_perf_test.sh - Compile and run zlib performance comparison
+# run_perf_test.sh - Compile and run the zlib benchmark harness
 #
 # This script:
-# 1. Compiles perf_zlib.c natively with gcc
-# 2. Compiles perf_zlib.c for WASM using WALI toolchain
-# 3. Runs both versions and displays results
+# 1. Compiles bench_zlib.c natively with gcc
+# 2. Compiles bench_zlib.c for WASM using WALI toolchain (and AOT with wamrc)
+# 3. Runs it once per runtime mode, saving JSON results
+# 4. Prints a throughput table and, with BASELINE set, compares against it
+#
+# Runtime modes are picked with MODES (space separated, default all):
+#   native      gcc build against host libz
+#   interp      iwasm --interp
+#   aot         bench_zlib.aot compiled by wamrc, run by iwasm
+#   fast-jit    iwasm --fast-jit
+# Modes whose tools are missing are skipped with a message.
+#
+# Both sides use whatever zlib they are linked against: host libz for the
+# native build, the runtime's lib-zlib natives for iwasm. bench_zlib labels
+# its results with the backend it finds (zlib or zlib-ng), and the table
+# has one row per backend.
+#
+# With ZLIB_NG_LIBDIR set to a directory holding zlib-ng built in compat
+# mode (libz.so.1), the native mode also runs against it through
+# LD_LIBRARY_PATH, so the table shows zlib and zlib-ng side by side.
+#
+# Other settings:
+#   RESULTS_DIR  where <mode>.json files go (default: temporary)
+#   BENCH_ARGS   extra bench_zlib options, e.g. "--reps 20 --filter inflate"
+#   BASELINE     results directory or file from an earlier run; regressions
+#                against it, or baseline cases missing from this run, make
+#                the script exit non-zero
+#   THRESHOLD    regression threshold in percent (default: 5)
 
 set -e
 
@@ -33,33 +58,51 @@ check_tool() {
 }
 
 check_tool gcc
+check_tool python3
 
 # Paths
-PERF_SRC="${SCRIPT_DIR}/perf_zlib.c"
-NATIVE_BIN="${SCRIPT_DIR}/perf_zlib_native"
-WASM_BIN="${SCRIPT_DIR}/perf_zlib.wasm"
+BENCH_SRC="${SCRIPT_DIR}/bench_zlib.c"
+NATIVE_BIN="${SCRIPT_DIR}/bench_zlib_native"
+WASM_BIN="${SCRIPT_DIR}/bench_zlib.wasm"
+AOT_BIN="${SCRIPT_DIR}/bench_zlib.aot"
+COMPARE="${SCRIPT_DIR}/compare_bench.py"
 IWASM="${WALI_ROOT}/build/wamr/iwasm/iwasm"
+WAMRC="${WAMRC:-${WALI_ROOT}/build/wamr/wamr-compiler/wamrc}"
 WALI_ENV="${WALI_ROOT}/.walienv"
 
 # WALI toolchain
 WALI_CC="${WALI_ROOT}/build/llvm/bin/clang"
 WALI_SYSROOT="${WALI_ROOT}/build/sysroot"
 
+MODES="${MODES:-native interp aot fast-jit}"
+THRESHOLD="${THRESHOLD:-5}"
+
+KEEP_RESULTS=1
+if [ -z "${RESULTS_DIR}" ]; then
+    KEEP_RESULTS=0
+    RESULTS_DIR="$(mktemp -d)"
+    trap 'rm -rf "${RESULTS_DIR}"' EXIT
+else
+    mkdir -p "${RESULTS_DIR}"
+fi
+
 # ============================================================================
 # Step 1: Compile native version
 # ============================================================================
 echo -e "${YELLOW}[1/4] Compiling native version...${NC}"
-gcc -O2 -o "${NATIVE_BIN}" "${PERF_SRC}" -lz
+gcc -O2 -o "${NATIVE_BIN}" "${BENCH_SRC}" -lz -lm
 echo -e "${GREEN}  ✓ Native binary: ${NATIVE_BIN}${NC}"
 
 # ============================================================================
-# Step 2: Compile WASM version
+# Step 2: Compile WASM (and AOT) version
 # ============================================================================
 echo -e "${YELLOW}[2/4] Compiling WASM version...${NC}"
 
+SKIP_WASM=0
+SKIP_AOT=0
 if [ ! -f "${WALI_CC}" ]; then
     echo -e "${RED}  ✗ WALI compiler not found at: ${WALI_CC}${NC}"
-    echo -e "${YELLOW}  Skipping WASM compilation...${NC}"
+    echo -e "${YELLOW}  Skipping WASM modes...${NC}"
     SKIP_WASM=1
 else
     # Use the same flags as compile.sh
@@ -75,68 +118,128 @@ else
         -matomics \
         -mbulk-memory \
         -mexception-handling \
-        -I"${WALI_ROOT}/cpython/wali_shims" \
+        -I"${WALI_ROOT}/wali_shims" \
         -L"${WALI_SYSROOT}/lib" \
         -Wl,--shared-memory \
         -Wl,--export-memory \
         -Wl,--max-memory=2147483648 \
         -o "${WASM_BIN}" \
-        "${PERF_SRC}"
+        "${BENCH_SRC}"
     echo -e "${GREEN}  ✓ WASM binary: ${WASM_BIN}${NC}"
-    SKIP_WASM=0
+
+    if [[ " ${MODES} " == *" aot "* ]]; then
+        if [ -x "${WAMRC}" ]; then
+            "${WAMRC}" --enable-multi-thread -o "${AOT_BIN}" "${WASM_BIN}" > /dev/null
+            echo -e "${GREEN}  ✓ AOT binary: ${AOT_BIN}${NC}"
+        else
+            echo -e "${YELLOW}  wamrc not found at: ${WAMRC}, skipping aot mode${NC}"
+            SKIP_AOT=1
+        fi
+    fi
+fi
+
+if [ "${SKIP_WASM}" != "1" ] && [ ! -f "${IWASM}" ]; then
+    echo -e "${RED}  ✗ iwasm not found at: ${IWASM}${NC}"
+    echo -e "${YELLOW}  Please build iwasm first:${NC}"
+    echo -e "${YELLOW}    cd ${WALI_ROOT}/build/wamr/iwasm && ninja${NC}"
+    SKIP_WASM=1
 fi
 
 # ============================================================================
-# Step 3: Run native version
+# Step 3: Run every mode, one JSON file each
 # ============================================================================
-echo ""
-echo -e "${CYAN}════════════════════════════════════════════════════════════════${NC}"
-echo -e "${CYAN}                    NATIVE EXECUTION                            ${NC}"
-echo -e "${CYAN}════════════════════════════════════════════════════════════════${NC}"
-echo ""
+echo -e "${YELLOW}[3/4] Running benchmarks...${NC}"
+
+run_wasm() {
+    local mode=$1
+    shift
+    local module="${WASM_BIN}"
+    local mode_flag=""
+
+    case "${mode}" in
+        interp)   mode_flag="--interp" ;;
+        fast-jit) mode_flag="--fast-jit" ;;
+        aot)      module="${AOT_BIN}" ;;
+    esac
+
+    # Results go to stdout; keep iwasm link warnings out of the JSON
+    "${IWASM}" ${mode_flag} \
+        --env-file="${WALI_ENV}" \
+        --stack-size=8388608 \
+        --heap-size=134217728 \
+        --dir=/ \
+        "${module}" "$@" 2> >(grep -v "warning: failed to link" >&2)
+}
+
+# Native run with zlib-ng's compat libz.so.1 preloaded ahead of host libz
+run_native_zlib_ng() {
+    local out="${RESULTS_DIR}/native-zlib-ng.json"
+
+    if [ ! -f "${ZLIB_NG_LIBDIR}/libz.so.1" ]; then
+        echo -e "${RED}  ✗ no libz.so.1 in ZLIB_NG_LIBDIR=${ZLIB_NG_LIBDIR}${NC}"
+        return 1
+    fi
+    echo -e "${CYAN}  native (zlib-ng)${NC}"
+    LD_LIBRARY_PATH="${ZLIB_NG_LIBDIR}${LD_LIBRARY_PATH:+:${LD_LIBRARY_PATH}}" \
+        "${NATIVE_BIN}" "$@" > "${out}" || return 1
+    # Without the compat build the row would just repeat host libz
+    if ! grep -q '"backend": "zlib-ng"' "${out}"; then
+        echo -e "${RED}  ✗ ${ZLIB_NG_LIBDIR}/libz.so.1 is not zlib-ng (compat mode)${NC}"
+        rm -f "${out}"
+        return 1
+    fi
+}
 
-"${NATIVE_BIN}"
-NATIVE_EXIT=$?
+FAILED=0
+for MODE in ${MODES}; do
+    OUT="${RESULTS_DIR}/${MODE}.json"
+    ARGS=(--format json --runtime "${MODE}" ${BENCH_ARGS})
+
+    if [ "${MODE}" = "native" ]; then
+        echo -e "${CYAN}  native${NC}"
+        "${NATIVE_BIN}" "${ARGS[@]}" > "${OUT}" || FAILED=1
+        if [ -n "${ZLIB_NG_LIBDIR}" ]; then
+            run_native_zlib_ng "${ARGS[@]}" || FAILED=1
+        fi
+        continue
+    fi
+    if [ "${SKIP_WASM}" = "1" ] || { [ "${MODE}" = "aot" ] && [ "${SKIP_AOT}" = "1" ]; }; then
+        echo -e "${YELLOW}  ${MODE}: skipped${NC}"
+        continue
+    fi
+    echo -e "${CYAN}  ${MODE}${NC}"
+    run_wasm "${MODE}" "${ARGS[@]}" > "${OUT}" || FAILED=1
+done
 
-if [ $NATIVE_EXIT -ne 0 ]; then
-    echo -e "${RED}Native execution failed with exit code: ${NATIVE_EXIT}${NC}"
+if [ "${FAILED}" = "1" ]; then
+    echo -e "${RED}  Some runs reported failed cases, see the messages above${NC}"
 fi
 
 # ============================================================================
-# Step 4: Run WASM version
+# Step 4: Throughput table and regression check
 # ============================================================================
-if [ "${SKIP_WASM}" = "1" ]; then
-    echo ""
-    echo -e "${YELLOW}Skipping WASM execution (compilation failed)${NC}"
-else
+echo ""
+echo -e "${BLUE}════════════════════════════════════════════════════════════════${NC}"
+echo -e "${BLUE}                    THROUGHPUT BY RUNTIME (MB/s)                ${NC}"
+echo -e "${BLUE}════════════════════════════════════════════════════════════════${NC}"
+echo ""
+python3 "${COMPARE}" "${RESULTS_DIR}"
+
+if [ -n "${BASELINE}" ]; then
     echo ""
-    echo -e "${CYAN}════════════════════════════════════════════════════════════════${NC}"
-    echo -e "${CYAN}                    WASM EXECUTION (iwasm)                      ${NC}"
-    echo -e "${CYAN}════════════════════════════════════════════════════════════════${NC}"
+    echo -e "${BLUE}════════════════════════════════════════════════════════════════${NC}"
+    echo -e "${BLUE}                    REGRESSIONS VS BASELINE                     ${NC}"
+    echo -e "${BLUE}════════════════════════════════════════════════════════════════${NC}"
     echo ""
-
-    if [ ! -f "${IWASM}" ]; then
-        echo -e "${RED}  ✗ iwasm not found at: ${IWASM}${NC}"
-        echo -e "${YELLOW}  Please build iwasm first:${NC}"
-        echo -e "${YELLOW}    cd ${WALI_ROOT}/build/wamr/iwasm && ninja${NC}"
-    else
-        # Run with WALI env file, suppress link warnings
-        "${IWASM}" \
-            --env-file="${WALI_ENV}" \
-            --stack-size=8388608 \
-            --heap-size=134217728 \
-            --dir=/ \
-            "${WASM_BIN}" 2>&1 | grep -v "warning: failed to link"
-        
-        WASM_EXIT=${PIPESTATUS[0]}
-        
-        if [ $WASM_EXIT -ne 0 ]; then
-            echo -e "${RED}WASM execution failed with exit code: ${WASM_EXIT}${NC}"
-        fi
-    fi
+    python3 "${COMPARE}" "${BASELINE}" "${RESULTS_DIR}" --threshold "${THRESHOLD}" || FAILED=1
 fi
 
 echo ""
 echo -e "${BLUE}════════════════════════════════════════════════════════════════${NC}"
 echo -e "${BLUE}                    COMPARISON COMPLETE                         ${NC}"
 echo -e "${BLUE}════════════════════════════════════════════════════════════════${NC}"
+if [ "${KEEP_RESULTS}" = "1" ]; then
+    echo "Results: ${RESULTS_DIR}"
+fi
+
+exit ${FAILED}
@@ -475,6 +475,98 @@ int test_compression_levels(void) {
     return 1;
 }
 
+int test_multi_member(void) {
+    TEST("Multi-member file");
+    
+    /* Members of very different sizes, including an empty one, appended
+     * one after another the way log rotation or pigz produces them */
+    const int member_lines[] = {1, 500, 0, 3000, 17, 1200, 1, 800};
+    int nmembers = sizeof(member_lines) / sizeof(member_lines[0]);
+    size_t cap = 0;
+    for (int m = 0; m < nmembers; m++) {
+        cap += member_lines[m] * 32;
+    }
+    
+    char *expect = malloc(cap + 1);
+    char *buf = malloc(cap + 1);
+    if (!expect || !buf) {
+        free(expect);
+        free(buf);
+        FAIL("Failed to allocate");
+    }
+    
+    size_t len = 0;
+    for (int m = 0; m < nmembers; m++) {
+        gzFile wf = gzopen(TEST_FILE, m == 0 ? "wb" : "ab");
+        if (!wf) {
+            free(expect);
+            free(buf);
+            FAIL("gzopen for write/append failed");
+        }
+        for (int i = 0; i < member_lines[m]; i++) {
+            char line[32];
+            int n = snprintf(line, sizeof(line), "Member %d line %d\n", m, i);
+            gzwrite(wf, line, n);
+            memcpy(expect + len, line, n);
+            len += n;
+        }
+        gzclose(wf);
+    }
+    printf("Wrote %d members, %zu bytes\n", nmembers, len);
+    
+    /* Read back in odd-sized chunks so reads straddle member boundaries */
+    gzFile rf = gzopen(TEST_FILE, "rb");
+    if (!rf) {
+        free(expect);
+        free(buf);
+        FAIL("gzopen for read failed");
+    }
+    
+    size_t total_read = 0;
+    int n;
+    while ((n = gzread(rf, buf + total_read, 997)) > 0) {
+        total_read += n;
+        if (total_read + 997 > cap) {
+            break;
+        }
+    }
+    while ((n = gzread(rf, buf + total_read, cap - total_read)) > 0) {
+        total_read += n;
+    }
+    
+    if (total_read != len || memcmp(expect, buf, len) != 0) {
+        printf("Read %zu of %zu bytes\n", total_read, len);
+        gzclose(rf);
+        free(expect);
+        free(buf);
+        FAIL("Multi-member data mismatch");
+    }
+    if (!gzeof(rf)) {
+        gzclose(rf);
+        free(expect);
+        free(buf);
+        FAIL("gzeof not set after last member");
+    }
+    
+    /* Seek back into the middle of a later member */
+    z_off_t pos = (z_off_t)(len * 3 / 4);
+    if (gzseek(rf, pos, SEEK_SET) != pos ||
+        gzread(rf, buf, 64) != 64 ||
+        memcmp(buf, expect + pos, 64) != 0) {
+        gzclose(rf);
+        free(expect);
+        free(buf);
+        FAIL("Seek into later member failed");
+    }
+    
+    gzclose(rf);
+    free(expect);
+    free(buf);
+    
+    PASS();
+    return 1;
+}
+
 int main(int argc, char *argv[]) {
     printf("==================================================\n");
     printf("WALI Gzip File I/O Test Suite\n");
@@ -488,6 +580,7 @@ int main(int argc, char *argv[]) {
     tests_passed += test_gzerror();
     tests_passed += test_gzungetc();
     tests_passed += test_large_file();
+    tests_passed += test_multi_member();
     tests_passed += test_compression_levels();
     
     printf("\n==================================================\n");
@@ -0,0 +1,104 @@
+"""
+    Decode WALI binary syscall traces (WALI_STRACE=bin:<path>, see
+    scripts/templates/wali_trace.h.template) into strace-style text, or
+    with -c into the same summary table as strace -c (strace_bench/*.trace).
+    Several files, e.g. one per forked process, are merged.
+"""
+import argparse
+import errno
+import os
+import struct
+import sys
+from datetime import datetime
+
+HEADER = struct.Struct('<8sIIQQII')
+RECORD = struct.Struct('<QQIHBBIIq6q')
+MAGIC = b'WALITRC1'
+DROPPED = 1
+
+
+def read_trace(path):
+    """ Yields (pid, names, real_offset_ns, record tuple) """
+    with open(path, 'rb') as f:
+        data = f.read()
+    magic, version, record_size, mono_start, real_start, pid, name_count = HEADER.unpack_from(data, 0)
+    if magic != MAGIC or version != 2:
+        sys.exit(f"{path}: not a WALI trace (version 2)")
+    if record_size != RECORD.size:
+        sys.exit(f"{path}: record size {record_size}, expected {RECORD.size}")
+    off = HEADER.size
+    names = {}
+    for _ in range(name_count):
+        nr, length = struct.unpack_from('<HB', data, off)
+        names[nr] = data[off + 3: off + 3 + length].decode()
+        off += 3 + length
+    # Trailing partial record: the runtime was killed mid-write
+    end = off + (len(data) - off) // RECORD.size * RECORD.size
+    for rec in RECORD.iter_unpack(data[off:end]):
+        yield pid, names, real_start - mono_start, rec
+
+
+def fmt_arg(v):
+    return hex(v & 0xffffffffffffffff) if v > 0xffff or v < -0xffff else str(v)
+
+
+def fmt_ret(ret):
+    if -4096 < ret < 0:
+        code = errno.errorcode.get(-ret, str(-ret))
+        return f"-1 {code} ({os.strerror(-ret)})"
+    return fmt_arg(ret)
+
+
+def print_text(records, show_time):
+    for pid, names, real_offset, (enter, dur, tid, nr, nargs, flags, dropped, _, ret, *args) in records:
+        if flags & DROPPED:
+            print(f"[pid {tid:>5}] +++ {dropped} records dropped +++")
+        prefix = f"[pid {tid:>5}] "
+        if show_time:
+            ts = datetime.fromtimestamp((enter + real_offset) / 1e9)
+            prefix += ts.strftime('%H:%M:%S.%f') + ' '
+        name = names.get(nr, f"syscall_{nr}")
+        print(f"{prefix}{name}({', '.join(fmt_arg(a) for a in args[:nargs])}) = {fmt_ret(ret)} <{dur / 1e9:.6f}>")
+
+
+def print_summary(records):
+    stats = {}
+    dropped_total = 0
+    for pid, names, _, (enter, dur, tid, nr, nargs, flags, dropped, _, ret, *args) in records:
+        s = stats.setdefault(names.get(nr, f"syscall_{nr}"), [0, 0, 0])
+        s[0] += dur
+        s[1] += 1
+        s[2] += -4096 < ret < 0
+        dropped_total += dropped if flags & DROPPED else 0
+
+    total_ns = sum(s[0] for s in stats.values()) or 1
+    print("% time     seconds  usecs/call     calls    errors syscall")
+    print("------ ----------- ----------- --------- --------- ----------------")
+    for name, (ns, calls, errors) in sorted(stats.items(), key=lambda kv: kv[1][0], reverse=True):
+        print("{:6.2f} {:11.6f} {:11d} {:9d} {:>9} {}".format(
+            100.0 * ns / total_ns, ns / 1e9, ns // 1000 // calls, calls, errors or '', name))
+    print("------ ----------- ----------- --------- --------- ----------------")
+    print("{:6.2f} {:11.6f} {:11} {:9d} {:>9} {}".format(
+        100.0, sum(s[0] for s in stats.values()) / 1e9, '',
+        sum(s[1] for s in stats.values()), sum(s[2] for s in stats.values()) or '', 'total'))
+    if dropped_total:
+        print(f"\n{dropped_total} records dropped (ring full); counts above exclude them")
+
+
+def main():
+    parser = argparse.ArgumentParser(prog='decode_trace', description="Decode WALI binary syscall traces")
+    parser.add_argument('traces', nargs='+', help='Trace files written with WALI_STRACE=bin:<path>')
+    parser.add_argument('-c', '--summary', action='store_true', help='strace -c style summary table')
+    parser.add_argument('-t', '--time', action='store_true', help='Prefix lines with wall-clock time')
+    args = parser.parse_args()
+
+    records = [r for path in args.traces for r in read_trace(path)]
+    if args.summary:
+        print_summary(records)
+    else:
+        records.sort(key=lambda r: r[3][0])
+        print_text(records, args.time)
+
+
+if __name__ == '__main__':
+    main()
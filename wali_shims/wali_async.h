@@ -0,0 +1,56 @@
+/* wali_shims/wali_async.h
+ * WASM shim header for asynchronous native-library calls
+ *
+ * A *_async import (e.g. compress2_async in zlib.h) queues the call on a
+ * host worker pool and returns a future at once, so the guest thread
+ * keeps running and can still take signals and enforce its own timeouts.
+ * Every buffer passed to an async call belongs to the call until the
+ * future completes: the guest must not touch or free it before then.
+ *
+ * Requires runtime support (not in this tree): these are WALI zlib
+ * extension imports, and zlib.h only pulls this header in when
+ * WALI_ZLIB_EXTENSIONS is defined.
+ */
+
+#ifndef WALI_ASYNC_H_
+#define WALI_ASYNC_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* Handle of a queued call; 0 means the call could not be queued */
+typedef uint32_t wali_future;
+
+/* Future states returned by wali_async_poll/wali_async_wait */
+#define WALI_ASYNC_PENDING    0   /* still queued or running */
+#define WALI_ASYNC_DONE       1   /* finished, *result holds its return code */
+#define WALI_ASYNC_CANCELLED  2   /* cancelled before it finished */
+#define WALI_ASYNC_TIMEOUT    3   /* wali_async_wait timed out, still pending */
+#define WALI_ASYNC_EINVAL   (-1)  /* unknown or already released future */
+
+/* Never blocks. On DONE or CANCELLED the future is released and *result
+ * (may be NULL) receives the call's return code. */
+__attribute__((import_module("env"), import_name("wali_async_poll")))
+int wali_async_poll(wali_future future, int *result);
+
+/* Blocks up to timeout_ns (negative: no limit), then behaves like poll.
+ * A signal delivered to the guest thread ends the wait early with
+ * WALI_ASYNC_PENDING, leaving the future intact. */
+__attribute__((import_module("env"), import_name("wali_async_wait")))
+int wali_async_wait(wali_future future, int64_t timeout_ns, int *result);
+
+/* Requests cancellation. Calls that have not started are dropped; running
+ * ones stop at their next chunk boundary. The future still has to be
+ * collected with poll/wait, which then reports CANCELLED (or DONE if the
+ * call finished first). */
+__attribute__((import_module("env"), import_name("wali_async_cancel")))
+int wali_async_cancel(wali_future future);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WALI_ASYNC_H_ */
@@ -0,0 +1,87 @@
+/* wali_shims/wali_batch.h
+ * WASM shim header for batched syscall submission
+ *
+ * Every WALI syscall is one guest -> host transition plus one kernel
+ * entry. wali_batch_submit takes an array of operations in linear memory
+ * and runs all of them with one transition; the host queues them on a
+ * per-thread io_uring and enters the kernel once per batch (falling back
+ * to plain syscalls, still one transition, where io_uring is unavailable).
+ *
+ * The call is synchronous: it returns once every operation has completed,
+ * so buffers only need to stay valid for the duration of the call.
+ * Operations in one batch may run concurrently unless chained with
+ * WALI_SQE_LINK; cqes[i] always holds the result of sqes[i].
+ */
+
+#ifndef WALI_BATCH_H_
+#define WALI_BATCH_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* Operations; addr/len/off are used as noted */
+#define WALI_OP_NOP      0
+#define WALI_OP_READ     1   /* pread(fd, addr, len, off); off -1: file position */
+#define WALI_OP_WRITE    2   /* pwrite(fd, addr, len, off); off -1: file position */
+#define WALI_OP_READV    3   /* preadv(fd, (struct iovec *)addr, len iovecs, off) */
+#define WALI_OP_WRITEV   4   /* pwritev(fd, (struct iovec *)addr, len iovecs, off) */
+#define WALI_OP_RECV     5   /* recv(fd, addr, len, off as flags) */
+#define WALI_OP_SEND     6   /* send(fd, addr, len, off as flags) */
+#define WALI_OP_ACCEPT   7   /* accept(fd, (struct sockaddr *)addr, (socklen_t *)off); addr may be 0 */
+#define WALI_OP_CLOSE    8   /* close(fd) */
+#define WALI_OP_FSYNC    9   /* fsync(fd) */
+
+/* wali_sqe.flags */
+#define WALI_SQE_LINK    1   /* start the next operation only after this one succeeds */
+
+/* As with io_uring, "succeeds" means in full: an error, or a READ/WRITE
+ * (READV/WRITEV: all iovecs; RECV/SEND: only with MSG_WAITALL) that
+ * transfers fewer than the requested bytes, including 0 at end of file,
+ * cancels the rest of the chain with -ECANCELED. */
+
+/* Largest batch accepted by one call */
+#define WALI_BATCH_MAX   256
+
+typedef struct wali_sqe {
+    uint8_t  opcode;
+    uint8_t  flags;
+    uint16_t reserved;
+    int32_t  fd;
+    int64_t  off;
+    uint32_t addr;           /* guest pointer */
+    uint32_t len;
+    uint64_t user_data;      /* copied to the matching completion */
+} wali_sqe;
+
+typedef struct wali_cqe {
+    uint64_t user_data;
+    int32_t  res;            /* syscall result, -errno on failure; -ECANCELED after a broken link */
+    uint32_t flags;
+} wali_cqe;
+
+/* Runs sqes[0..count) and writes their completions to cqes[0..count).
+ * Returns count, or -errno if the batch was rejected as a whole
+ * (bad pointer, count > WALI_BATCH_MAX, unknown opcode). */
+__attribute__((import_module("wali"), import_name("wali_batch_submit")))
+int wali_batch_submit(const wali_sqe *sqes, uint32_t count, wali_cqe *cqes);
+
+static inline void wali_sqe_prep(wali_sqe *sqe, uint8_t opcode, int fd, void *addr,
+                                 uint32_t len, int64_t off, uint64_t user_data) {
+    sqe->opcode = opcode;
+    sqe->flags = 0;
+    sqe->reserved = 0;
+    sqe->fd = fd;
+    sqe->off = off;
+    sqe->addr = (uint32_t)(uintptr_t)addr;
+    sqe->len = len;
+    sqe->user_data = user_data;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WALI_BATCH_H_ */
@@ -0,0 +1,67 @@
+/* wali_shims/wali_bench.h
+ * WASM shim header for the host-call overhead benchmark natives
+ * (tests/hostcall_bench/lib_bench.c). Every import is a no-op on the
+ * host; what is measured is the transition for each signature class.
+ */
+
+#ifndef WALI_BENCH_H_
+#define WALI_BENCH_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* Same shape as the fields wali_deflate/wali_inflate sync per call */
+typedef struct wali_bench_stream_s {
+    uint32_t next_in;
+    uint32_t avail_in;
+    uint32_t total_in;
+    uint32_t next_out;
+    uint32_t avail_out;
+    uint32_t total_out;
+    uint32_t msg;
+    uint32_t state;
+    uint32_t zalloc;
+    uint32_t zfree;
+    uint32_t opaque;
+    int32_t  data_type;
+    uint32_t adler;
+    uint32_t reserved;
+} wali_bench_stream;
+
+/* "()i" */
+__attribute__((import_module("env"), import_name("wali_bench_void")))
+int wali_bench_void(void);
+
+/* "(i)i" */
+__attribute__((import_module("env"), import_name("wali_bench_i")))
+int wali_bench_i(int a);
+
+/* "(iiiI)i", the shape of wali_compress */
+__attribute__((import_module("env"), import_name("wali_bench_iiiI")))
+int wali_bench_iiiI(int a, int b, int c, int64_t d);
+
+/* "(IIII)I" */
+__attribute__((import_module("env"), import_name("wali_bench_IIII")))
+int64_t wali_bench_IIII(int64_t a, int64_t b, int64_t c, int64_t d);
+
+/* "(*~*~)i": the runtime validates both buffers before the call */
+__attribute__((import_module("env"), import_name("wali_bench_ptr_checked")))
+int wali_bench_ptr_checked(const void *src, uint32_t src_len, void *dst, uint32_t dst_len);
+
+/* "(iiii)i": same arguments, translated by the native without validation */
+__attribute__((import_module("env"), import_name("wali_bench_ptr_raw")))
+int wali_bench_ptr_raw(const void *src, uint32_t src_len, void *dst, uint32_t dst_len);
+
+/* "(i)i": validates strm, translates every field to a native mirror and
+ * writes them back, like a z_stream sync */
+__attribute__((import_module("env"), import_name("wali_bench_struct")))
+int wali_bench_struct(wali_bench_stream *strm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WALI_BENCH_H_ */
@@ -0,0 +1,159 @@
+/* wali_shims/wali_vdso.h
+ * Guest view of the WALI "vdso" page
+ *
+ * The runtime publishes a small data page in linear memory and keeps it
+ * current from a host thread: a seqlock-protected clock snapshot taken
+ * every tick_ns, the pid and a fork generation. Reading it costs a few
+ * loads instead of a wali_syscall_* transition. The page is
+ * wali_vdso_storage below, in the guest's data segment rather than its
+ * heap, so nothing in the guest ever frees or reuses it.
+ *
+ * Unlike a kernel vDSO there is no cycle counter a guest can read to
+ * extrapolate between ticks, so the snapshot has tick resolution. The
+ * readers below therefore serve CLOCK_*_COARSE always, and the precise
+ * clocks only when the runtime advertises WALI_VDSO_TICK_CLOCKS (opt-in,
+ * WALI_VDSO_TICK_CLOCKS=1 on the host); otherwise they return -1 and the
+ * caller makes the normal syscall. Only code that includes this header and
+ * calls the readers benefits: the wali-musl hook that would route
+ * clock_gettime, gettimeofday, getpid and gettid through them is not in
+ * this tree.
+ *
+ * Requires runtime support: tests/vdso/lib_vdso.c registered in the
+ * runtime (not in this tree). Timings: tests/vdso/perf_vdso.c.
+ */
+
+#ifndef WALI_VDSO_H_
+#define WALI_VDSO_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#define WALI_VDSO_MAGIC         0x4f534457u   /* "WDSO" */
+#define WALI_VDSO_VERSION       1
+
+/* wali_vdso_data.flags */
+#define WALI_VDSO_TICK_CLOCKS   1   /* precise clocks may be served at tick resolution */
+
+typedef struct wali_vdso_ts {
+    int64_t sec;
+    int64_t nsec;
+} wali_vdso_ts;
+
+typedef struct wali_vdso_data {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t flags;
+    uint32_t seq;               /* odd while the host is writing */
+    int64_t  tick_ns;           /* update period, reported by clock_getres */
+    wali_vdso_ts realtime;
+    wali_vdso_ts monotonic;
+    wali_vdso_ts boottime;
+    int32_t  pid;
+    uint32_t fork_gen;          /* bumped in a forked child before it resumes */
+} wali_vdso_data;
+
+/* Weak, so every translation unit including this header shares one copy */
+__attribute__((weak, aligned(8))) volatile wali_vdso_data wali_vdso_storage;
+
+/* Hands storage to the runtime on the first call and returns the guest
+ * address of the process's page (that first storage), 0 if the runtime
+ * has none. One call per process is enough; the readers below cache it. */
+__attribute__((import_module("wali"), import_name("wali_vdso_page")))
+uint32_t wali_vdso_page(volatile wali_vdso_data *storage, uint32_t size);
+
+static inline const volatile wali_vdso_data *wali_vdso_get(void) {
+    static const volatile wali_vdso_data *page;
+    static int probed;
+    if (!probed) {
+        const volatile wali_vdso_data *p = (const volatile wali_vdso_data *)(uintptr_t)
+            wali_vdso_page(&wali_vdso_storage, sizeof(wali_vdso_storage));
+        page = p && p->magic == WALI_VDSO_MAGIC && p->version == WALI_VDSO_VERSION ? p : 0;
+        probed = 1;
+    }
+    return page;
+}
+
+/* 0 and *ts filled, or -1: use the syscall */
+static inline int wali_vdso_clock_gettime(clockid_t clk, struct timespec *ts) {
+    const volatile wali_vdso_data *d = wali_vdso_get();
+    const volatile wali_vdso_ts *src;
+    uint32_t seq;
+    int64_t sec, nsec;
+
+    if (!d) {
+        return -1;
+    }
+    switch (clk) {
+    case CLOCK_REALTIME_COARSE:
+        src = &d->realtime;
+        break;
+    case CLOCK_MONOTONIC_COARSE:
+        src = &d->monotonic;
+        break;
+    case CLOCK_REALTIME:
+    case CLOCK_MONOTONIC:
+    case CLOCK_BOOTTIME:
+        if (!(d->flags & WALI_VDSO_TICK_CLOCKS)) {
+            return -1;
+        }
+        src = clk == CLOCK_REALTIME ? &d->realtime
+            : clk == CLOCK_MONOTONIC ? &d->monotonic : &d->boottime;
+        break;
+    default:
+        return -1;
+    }
+    do {
+        while ((seq = __atomic_load_n(&d->seq, __ATOMIC_ACQUIRE)) & 1) {
+        }
+        sec = src->sec;
+        nsec = src->nsec;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while (__atomic_load_n(&d->seq, __ATOMIC_RELAXED) != seq);
+
+    ts->tv_sec = (time_t)sec;
+    ts->tv_nsec = (long)nsec;
+    return 0;
+}
+
+static inline int wali_vdso_clock_getres(clockid_t clk, struct timespec *res) {
+    const volatile wali_vdso_data *d = wali_vdso_get();
+    struct timespec ts;
+    if (!d || wali_vdso_clock_gettime(clk, &ts) != 0) {
+        return -1;
+    }
+    res->tv_sec = (time_t)(d->tick_ns / 1000000000);
+    res->tv_nsec = (long)(d->tick_ns % 1000000000);
+    return 0;
+}
+
+static inline pid_t wali_vdso_getpid(void) {
+    const volatile wali_vdso_data *d = wali_vdso_get();
+    return d ? (pid_t)d->pid : (pid_t)syscall(SYS_getpid);
+}
+
+/* The tid is cached per thread and re-fetched after a fork */
+static inline pid_t wali_vdso_gettid(void) {
+    static __thread pid_t tid;
+    static __thread uint32_t gen;
+    const volatile wali_vdso_data *d = wali_vdso_get();
+    if (!d) {
+        return (pid_t)syscall(SYS_gettid);
+    }
+    if (!tid || gen != d->fork_gen) {
+        gen = d->fork_gen;
+        tid = (pid_t)syscall(SYS_gettid);
+    }
+    return tid;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WALI_VDSO_H_ */
@@ -12,6 +12,9 @@ extern "C" {
 
 #include <stddef.h>
 #include <stdint.h>
+#ifdef WALI_ZLIB_EXTENSIONS
+#include "wali_async.h"
+#endif
 
 /* ===== Version and constants ===== */
 #define ZLIB_VERSION "1.3"
@@ -42,6 +45,21 @@ extern "C" {
 #define Z_RLE                 3
 #define Z_FIXED               4
 
+#ifdef WALI_ZLIB_EXTENSIONS
+/* WALI extension, requires runtime support (not in this tree): OR into an
+ * explicit level 0-9 of compress2/gzsetparams to deflate large inputs on
+ * the host thread pool. Output is still a single standard zlib/gzip
+ * stream; inputs below the runtime's block size are compressed serially.
+ * Do not combine it with Z_DEFAULT_COMPRESSION: -1 | Z_WALI_PARALLEL is
+ * still -1, so the flag would be lost. Z_WALI_PARALLEL_LEVEL(level) turns
+ * anything outside 0-9 into an invalid level, so the call fails with
+ * Z_STREAM_ERROR instead of silently running serially. A runtime without
+ * parallel mode rejects a flagged level the same way. */
+#define Z_WALI_PARALLEL       0x100
+#define Z_WALI_PARALLEL_LEVEL(level) \
+        ((level) >= 0 && (level) <= 9 ? (level) | Z_WALI_PARALLEL : Z_STREAM_ERROR)
+#endif
+
 /* Return codes */
 #define Z_OK            0
 #define Z_STREAM_END    1
@@ -182,6 +200,12 @@ __attribute__((import_module("env"), import_name("wali_deflateGetDictionary")))
 int deflateGetDictionary(z_streamp strm,
                          Bytef *dictionary, uInt *dictLength);
 
+/* Requires runtime support (not in this tree): a runtime built with the
+ * WALI zlib extensions honours WALI_ZLIB_COW_COPY=1 in its environment by
+ * sharing the source's window and hash pages copy-on-write in deflateCopy
+ * and inflateCopy, so forking a primed stream costs page-table work
+ * instead of a full copy. The lib-zlib natives here always copy in full;
+ * either way the streams stay independent. */
 __attribute__((import_module("env"), import_name("wali_deflateCopy")))
 int deflateCopy(z_streamp dest, z_streamp source);
 
@@ -240,6 +264,7 @@ __attribute__((import_module("env"), import_name("wali_inflateGetDictionary")))
 int inflateGetDictionary(z_streamp strm,
                          Bytef *dictionary, uInt *dictLength);
 
+/* Copy-on-write under WALI_ZLIB_COW_COPY=1 where supported, see deflateCopy */
 __attribute__((import_module("env"), import_name("wali_inflateCopy")))
 int inflateCopy(z_streamp dest, z_streamp source);
 
@@ -304,20 +329,95 @@ uLong zlibCompileFlags(void);
 __attribute__((import_module("env"), import_name("wali_zError")))
 const char *zError(int err);
 
+/* Checksums of buffers shorter than WALI_ZLIB_INLINE_CKSUM_MAX bytes are
+ * computed in the guest, where they cost far less than the host
+ * transition; longer buffers go to the host's SIMD/PCLMUL implementation.
+ * Define it to 0 before including this header to always call the host.
+ * perf_checksum.c in tests/zlib_test measures the crossover point. */
+#ifndef WALI_ZLIB_INLINE_CKSUM_MAX
+#define WALI_ZLIB_INLINE_CKSUM_MAX 64
+#endif
+
+/* Adler-32 sums are reduced once per call, which is exact up to NMAX */
+#if WALI_ZLIB_INLINE_CKSUM_MAX > 5552
+#error "WALI_ZLIB_INLINE_CKSUM_MAX must not exceed 5552"
+#endif
+
 __attribute__((import_module("env"), import_name("wali_adler32")))
-uLong adler32(uLong adler, const Bytef *buf, uInt len);
+uLong wali_adler32_host(uLong adler, const Bytef *buf, uInt len);
 
 __attribute__((import_module("env"), import_name("wali_adler32_z")))
-uLong adler32_z(uLong adler, const Bytef *buf, z_size_t len);
+uLong wali_adler32_z_host(uLong adler, const Bytef *buf, z_size_t len);
+
+__attribute__((import_module("env"), import_name("wali_crc32")))
+uLong wali_crc32_host(uLong crc, const Bytef *buf, uInt len);
+
+__attribute__((import_module("env"), import_name("wali_crc32_z")))
+uLong wali_crc32_z_host(uLong crc, const Bytef *buf, z_size_t len);
+
+static inline uLong wali_adler32_small(uLong adler, const Bytef *buf, z_size_t len) {
+    uint32_t a = adler & 0xffff;
+    uint32_t b = (adler >> 16) & 0xffff;
+
+    while (len--) {
+        a += *buf++;
+        b += a;
+    }
+    return ((b % 65521) << 16) | (a % 65521);
+}
+
+static inline uLong wali_crc32_small(uLong crc, const Bytef *buf, z_size_t len) {
+    /* Half-byte table for the reflected CRC-32 polynomial 0xedb88320 */
+    static const uint32_t tab[16] = {
+        0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac,
+        0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+        0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c,
+        0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c
+    };
+    uint32_t c = ~(uint32_t)crc;
+
+    while (len--) {
+        c ^= *buf++;
+        c = (c >> 4) ^ tab[c & 15];
+        c = (c >> 4) ^ tab[c & 15];
+    }
+    return ~c;
+}
+
+static inline uLong adler32(uLong adler, const Bytef *buf, uInt len) {
+    if (buf == Z_NULL)
+        return 1;
+    if (len < WALI_ZLIB_INLINE_CKSUM_MAX)
+        return wali_adler32_small(adler, buf, len);
+    return wali_adler32_host(adler, buf, len);
+}
+
+static inline uLong adler32_z(uLong adler, const Bytef *buf, z_size_t len) {
+    if (buf == Z_NULL)
+        return 1;
+    if (len < WALI_ZLIB_INLINE_CKSUM_MAX)
+        return wali_adler32_small(adler, buf, len);
+    return wali_adler32_z_host(adler, buf, len);
+}
 
 __attribute__((import_module("env"), import_name("wali_adler32_combine")))
 uLong adler32_combine(uLong adler1, uLong adler2, z_off_t len2);
 
-__attribute__((import_module("env"), import_name("wali_crc32")))
-uLong crc32(uLong crc, const Bytef *buf, uInt len);
+static inline uLong crc32(uLong crc, const Bytef *buf, uInt len) {
+    if (buf == Z_NULL)
+        return 0;
+    if (len < WALI_ZLIB_INLINE_CKSUM_MAX)
+        return wali_crc32_small(crc, buf, len);
+    return wali_crc32_host(crc, buf, len);
+}
 
-__attribute__((import_module("env"), import_name("wali_crc32_z")))
-uLong crc32_z(uLong crc, const Bytef *buf, z_size_t len);
+static inline uLong crc32_z(uLong crc, const Bytef *buf, z_size_t len) {
+    if (buf == Z_NULL)
+        return 0;
+    if (len < WALI_ZLIB_INLINE_CKSUM_MAX)
+        return wali_crc32_small(crc, buf, len);
+    return wali_crc32_z_host(crc, buf, len);
+}
 
 __attribute__((import_module("env"), import_name("wali_crc32_combine")))
 uLong crc32_combine(uLong crc1, uLong crc2, z_off_t len2);
@@ -330,6 +430,13 @@ uLong crc32_combine_op(uLong crc1, uLong crc2, uLong op);
 
 /* ===== Gzip file I/O functions ===== */
 
+/* Requires runtime support (not in this tree): a runtime built with the
+ * WALI zlib extensions also accepts 'A' in the mode (e.g. "rbA", "wb6A")
+ * for an asynchronous file, where a host worker inflates ahead or deflates
+ * and writes behind through a ring of buffers so gzread/gzwrite only copy;
+ * worker errors surface on the next call or on gzclose. The lib-zlib
+ * natives in this tree hand the mode to zlib, which ignores 'A', so such a
+ * file is an ordinary synchronous one. */
 __attribute__((import_module("env"), import_name("wali_gzopen")))
 gzFile gzopen(const char *path, const char *mode);
 
@@ -342,6 +449,14 @@ int gzbuffer(gzFile file, unsigned size);
 __attribute__((import_module("env"), import_name("wali_gzsetparams")))
 int gzsetparams(gzFile file, int level, int strategy);
 
+/* Larger len means fewer bridge calls. Requires runtime support (not in
+ * this tree): a runtime built with the WALI zlib extensions memory-maps a
+ * regular file opened read-only ("rb") and inflates straight from the
+ * mapping into buf, so gzbuffer has no effect on such files; the lib-zlib
+ * natives here use zlib's own buffered gzread. Such a runtime may also
+ * inflate multi-member files (concatenated gzip streams) a few members
+ * ahead on the host thread pool; either way gzread returns the data in
+ * file order. */
 __attribute__((import_module("env"), import_name("wali_gzread")))
 int gzread(gzFile file, voidp buf, unsigned len);
 
@@ -405,6 +520,123 @@ const char *gzerror(gzFile file, int *errnum);
 __attribute__((import_module("env"), import_name("wali_gzclearerr")))
 void gzclearerr(gzFile file);
 
+/* ===== WALI extensions (no native zlib equivalent) ===== */
+
+/* The declarations below are imports that only a runtime built with the
+ * WALI zlib extensions provides; the lib-zlib natives this tree is built
+ * against do not have them, and a guest that calls one traps on the
+ * unresolved import. They are only declared when WALI_ZLIB_EXTENSIONS is
+ * defined, so code that uses them has to opt in explicitly. */
+
+#ifdef WALI_ZLIB_EXTENSIONS
+/* Bridge counters for the calling instance. Fields are only ever appended:
+ * the runtime fills the first stats_size bytes it knows about and zeroes
+ * the rest, so guests built against a newer header keep working. */
+typedef struct wali_zstats_s {
+    uint64_t sync_calls;     /* z_stream syncs between guest and host */
+    uint64_t sync_fields;    /* fields translated by those syncs */
+    uint64_t sync_skipped;   /* host->guest syncs skipped (no state change) */
+    uint64_t sync_ns;        /* time spent syncing, in nanoseconds */
+    /* Stream pool: only a runtime that pools native Init state fills these
+     * (not in this tree); others leave them 0 */
+    uint64_t pool_hits;      /* Init calls served from a pooled native state */
+    uint64_t pool_misses;    /* Init calls that allocated a fresh state */
+    /* Only filled by a runtime that allocates native zlib state from a
+     * per-instance arena (not in this tree); others leave them 0 */
+    uint64_t mem_live;       /* bytes of native zlib state held right now */
+    uint64_t mem_peak;       /* high-water mark of mem_live */
+    uint64_t mem_limit_hits; /* allocations refused by the memory cap */
+} wali_zstats;
+
+/* Requires runtime support (not in this tree): a runtime that allocates
+ * native zlib state (windows, hash chains, gz buffers) from a per-instance
+ * arena can be started with a zlib memory cap. An Init or gzopen that
+ * would exceed it then fails with Z_MEM_ERROR (gzopen returns 0) and
+ * counts a mem_limit_hit. */
+
+/* Copies the counters to stats (may be NULL) and clears them if reset is set */
+__attribute__((import_module("env"), import_name("wali_zlibStats_")))
+int zlibStats_(wali_zstats *stats, int reset, int stats_size);
+
+#define zlibStats(stats, reset) \
+        zlibStats_((stats), (reset), (int)sizeof(wali_zstats))
+#endif /* WALI_ZLIB_EXTENSIONS */
+
+#ifdef WALI_ZLIB_EXTENSIONS
+/* Batched one-shot calls: every item is processed in a single host call.
+ * They return Z_OK if all items succeeded, otherwise the status of the
+ * first failed item; status and dstLen are filled in for every item. */
+typedef struct z_batch_s {
+    const Bytef *src;        /* input buffer */
+    uLong        srcLen;     /* bytes at src */
+    Bytef       *dst;        /* output buffer (unused by crc32_batch) */
+    uLong        dstCap;     /* space at dst */
+    uLong        dstLen;     /* out: bytes written to dst, or the checksum */
+    int          status;     /* out: Z_OK or the zlib error for this item */
+} z_batch;
+
+__attribute__((import_module("env"), import_name("wali_compress_batch")))
+int compress_batch(z_batch *items, uInt count, int level);
+
+__attribute__((import_module("env"), import_name("wali_uncompress_batch")))
+int uncompress_batch(z_batch *items, uInt count);
+
+/* dstLen of each item receives crc32(crc, src, srcLen) */
+__attribute__((import_module("env"), import_name("wali_crc32_batch")))
+int crc32_batch(uLong crc, z_batch *items, uInt count);
+#endif /* WALI_ZLIB_EXTENSIONS */
+
+#ifdef WALI_ZLIB_EXTENSIONS
+/* Shared dictionaries: loaded once into host memory and shared by every
+ * instance and thread. Attaching by ID skips copying the dictionary out of
+ * linear memory, and deflate starts from a precomputed hash-chain snapshot
+ * instead of re-hashing the dictionary. IDs are never 0. */
+typedef uint32_t z_dict_id;
+
+__attribute__((import_module("env"), import_name("wali_zdict_register")))
+z_dict_id zdict_register(const Bytef *dictionary, uInt dictLength);
+
+__attribute__((import_module("env"), import_name("wali_zdict_release")))
+int zdict_release(z_dict_id id);
+
+__attribute__((import_module("env"), import_name("wali_deflateSetDictionaryId")))
+int deflateSetDictionaryId(z_streamp strm, z_dict_id id);
+
+__attribute__((import_module("env"), import_name("wali_inflateSetDictionaryId")))
+int inflateSetDictionaryId(z_streamp strm, z_dict_id id);
+#endif /* WALI_ZLIB_EXTENSIONS */
+
+#ifdef WALI_ZLIB_EXTENSIONS
+/* Random-access index for a gzFile opened for reading. Access points
+ * (a 32 KB window snapshot) are recorded every span bytes of uncompressed
+ * data as the file is read, and gzseek/gzrewind resume from the nearest
+ * one instead of re-inflating from the start. span 0 picks the runtime
+ * default. If index_path is not NULL it names a sidecar file: a matching
+ * index there is loaded, otherwise the finished index is written to it. */
+__attribute__((import_module("env"), import_name("wali_gzindex")))
+int gzindex(gzFile file, z_off_t span, const char *index_path);
+#endif /* WALI_ZLIB_EXTENSIONS */
+
+#ifdef WALI_ZLIB_EXTENSIONS
+/* Async variants (see wali_async.h): same arguments and result codes as
+ * the blocking calls, delivered through the future. destLen and buf are
+ * written when the call completes. A gzFile with an async call pending
+ * must not be used for anything else until the future is collected. */
+__attribute__((import_module("env"), import_name("wali_compress2_async")))
+wali_future compress2_async(Bytef *dest, uLongf *destLen,
+                            const Bytef *source, uLong sourceLen, int level);
+
+__attribute__((import_module("env"), import_name("wali_uncompress_async")))
+wali_future uncompress_async(Bytef *dest, uLongf *destLen,
+                             const Bytef *source, uLong sourceLen);
+
+__attribute__((import_module("env"), import_name("wali_gzread_async")))
+wali_future gzread_async(gzFile file, voidp buf, unsigned len);
+
+__attribute__((import_module("env"), import_name("wali_gzwrite_async")))
+wali_future gzwrite_async(gzFile file, voidpc buf, unsigned len);
+#endif /* WALI_ZLIB_EXTENSIONS */
+
 /* 64-bit variants (same as regular on WALI since z_off_t is 64-bit) */
 #define gzseek64 gzseek
 #define gztell64 gztell